@@ -18,8 +18,30 @@
 #include <dw/rig/Rig.h>
 
 #include <ros/ros.h>
+#include <diagnostic_msgs/DiagnosticArray.h>
+#include <sensor_msgs/CameraInfo.h>
 
+#include "camera_config.h"
+#include "camera_encoder.h"
+#include "camera_rectifier.h"
+#include "camera_recorder.h"
+#include "capture_health.h"
+#include "egl_stream_producer.h"
+#include "frame_conversion_kernels.h"
+#include "frame_ring.h"
+#include "group_tensor.h"
+#include "image_pool.h"
+#include "pipeline_stats.h"
+#include "sensor_base.h"
+#include "shm_ring.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 /**
  * @file camera.h
@@ -38,63 +60,236 @@
 namespace nv
 {
 
+  /**
+   * @struct CameraCounters
+   * @brief Per camera frame counters of the capture and convert stages
+   */
+  struct CameraCounters
+  {
+    /** Frames read from the sensor. */
+    std::atomic<uint64_t> captured{0};
+    /** Frames converted and sent to the streamers of all outputs. */
+    std::atomic<uint64_t> converted{0};
+    /** Frames returned unconverted because no output had a subscriber (~lazy). */
+    std::atomic<uint64_t> idle{0};
+    /** Frames the sensor skipped, estimated from gaps of the timestamps against the frame period. */
+    std::atomic<uint64_t> sensorDropped{0};
+  };
+
+  /**
+   * @struct CapturedFrame
+   * @brief A camera frame passed between the capture and convert stages
+   * @details Held in a preallocated capture slot, the ring between the stages
+   * carries the slot index only.
+   */
+  struct CapturedFrame
+  {
+    dwCameraFrameHandle_t frame;
+    /** Stamp shared by all frames of a group capture, 0 keeps the stamp of the frame. */
+    dwTime_t timestamp;
+    /** Sensor frame number published as header.seq, skipped sensor frames leave a gap; kept in the slot, not in the ring. */
+    uint32_t seq;
+  };
+
+  /**
+   * @struct OutputCounters
+   * @brief Per output frame counters of the receive and publish stages
+   */
+  struct OutputCounters
+  {
+    /** Frames not converted for the output because it had no subscriber (~lazy). */
+    std::atomic<uint64_t> skipped{0};
+    /** Frames not converted for the output because of its rate limit. */
+    std::atomic<uint64_t> decimated{0};
+    /** Frames not converted for the output because all its streamer targets stayed in flight (drop policies). */
+    std::atomic<uint64_t> convertDropped{0};
+    /** Frames received from the streamer. */
+    std::atomic<uint64_t> received{0};
+    /** Streamed frames dropped because every pooled message was in flight. */
+    std::atomic<uint64_t> receiveDropped{0};
+    /** New frames not queued because the publish ring was full (drop-newest). */
+    std::atomic<uint64_t> ringRejected{0};
+    /** New frames not queued because the publish ring stayed full until the deadline (block). */
+    std::atomic<uint64_t> deadlineMissed{0};
+    /** Frames handed to roscpp. */
+    std::atomic<uint64_t> published{0};
+    /** Frames written to the shared-memory ring and published as descriptor. */
+    std::atomic<uint64_t> shmPublished{0};
+  };
+
   /**
    * @class SensorCamera
    * @brief A utility class for initialization of CAMERA sensor
    * @details SensorCamera is a class through which user can
    * perform initialization, start and stop of data acquisition
-   * from camera sensor.
+   * from camera sensor. A single instance can serve up to MAX_CAMERAS
+   * cameras sharing one Driveworks context and SAL instance, each with
+   * its own capture pipeline and topic.
    */
-  class SensorCamera
+  class SensorCamera : public SensorBase
   {
 
   public:
-    /**
-     * @brief Initailization of SensorCamera class
-     * @details This API is required to initailize the SensorCamera class
-     * and provide the Driveworks handle and SAL handle.
-     *
-     * @param context Driveworks SDK handle
-     * @param hal Driveworks SAL handle
-     */
-    void initialize(dwContextHandle_t context, dwSALHandle_t hal);
+    /** Maximum number of cameras served by one SensorCamera instance. */
+    static const uint32_t MAX_CAMERAS = 16;
+
+    /** Maximum number of frames in flight through one streamer. */
+    static const uint32_t MAX_STREAMER_DEPTH = 4;
+
+    /** Frames an EGLStream holds at most without the consumer falling behind, the mailbox and the acquired one. */
+    static const uint32_t EGL_STREAM_FRAMES = 2;
+
+    /** Maximum number of streamer targets of one output. */
+    static const uint32_t MAX_STREAMER_TARGETS = MAX_STREAMER_DEPTH + EGL_STREAM_FRAMES;
+
+    /** Maximum number of transformed outputs of one camera. */
+    static const uint32_t MAX_OUTPUTS = MAX_CAMERA_OUTPUTS;
+
+    /** Separator between per-camera parameter sets in a start request. */
+    static const char CAMERA_PARAMS_SEPARATOR = ';';
 
     /**
      * @brief Initailization of camera sensor
      * @details This API is required to initailize the camera sensor
-     * and start data acquitsion
+     * and start data acquitsion. The parameters string may hold several
+     * camera parameter sets separated by CAMERA_PARAMS_SEPARATOR, in which
+     * case one camera is opened per set and camera n publishes on
+     * topic cameraData_<n>. A single set publishes on cameraData. A camera
+     * with output= options publishes every output on <topic>/<name>.
+     * A sensor exposing several siblings (cameras sharing one trigger on a
+     * CSI port) is opened as a group, every sibling is published as a camera
+     * of its own with identical stamps and the group on cameraGroup.
+     * If the cameras were prepared with the same parameters, only the
+     * sensors and the pipeline threads are started.
      *
      * @param params Driveworks Sensors params list
      *
      * @return true if execution successful
      *         false otherwise
      */
-    bool start(dwSensorParams params);
+    virtual bool start(dwSensorParams params);
+
+    /**
+     * @brief Preparation of camera sensors
+     * @details Creates the sensors, images, streamers, transformation
+     * engines, encoders, tensors and message pools of a start request and
+     * advertises the topics without starting the sensors. Prepared cameras
+     * stay allocated across start() and stop() until release(), so a start
+     * with the same parameters only calls dwSensor_start() and a stop only
+     * dwSensor_stop().
+     *
+     * @param params Driveworks Sensors params list, as for start()
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool prepare(dwSensorParams params);
 
     /**
      * @brief Release of camera sensor
      * @details This API is required to release the camera sensor
-     * and stop data acquitsion
+     * and stop data acquitsion. Prepared cameras are only stopped.
      *
      * @return true if execution successful
      *         false otherwise
      */
-    bool stop();
+    virtual bool stop();
 
     /**
-     * @brief Setting of Publisher
-     * @details This API is required to set ros::Publisher for the camera sensor
+     * @brief Release of prepared camera sensors
+     * @details Stops running cameras and frees everything prepare() allocated.
+     */
+    virtual void release();
+
+    /** @return true if cameras are allocated for a start request */
+    bool isPrepared() const
+    {
+      return m_prepared;
+    }
+
+    /**
+     * @brief Reconfiguration of the outputs of a running camera
+     * @details Applies output options (output-encoding, output-domain,
+     * output=..., publish-rate, raw-output) to one camera while its
+     * sensor keeps streaming. Only the convert, receive and publish stages of
+     * the camera are stopped and their images, streamers, transformation and
+     * message pools rebuilt; frames read meanwhile are handed back to the
+     * driver by the capture ring. Options not given keep their value, given
+     * output= options replace all outputs. Sensor, encoder and tensor options
+     * need a restart. If the new outputs cannot be created the previous ones
+     * are restored.
      *
-     * @params pub Pointer to ros::Publisher
+     * @param index camera index
+     * @param params comma separated output options
      *
      * @return true if execution successful
      *         false otherwise
      */
-    void setPublisher(ros::Publisher *pub)
+    bool reconfigure(uint32_t index, const std::string &params);
+
+    /**
+     * @brief Start of a disk recording
+     * @details Records the native frames of running cameras encoded (h264,
+     * h265) or unmodified (raw) to <directory>/<topic>_<n>.<format> segment
+     * files of ~record_segment_size MB with the index <directory>/<topic>.idx,
+     * without going through the ROS transport. Encoded recordings share
+     * bitrate, GOP and frame rate with the encoder options of the camera.
+     *
+     * @param cameras camera indices, empty records every camera
+     * @param directory directory of the recording, created if missing
+     * @param format h264, h265 or raw, empty records h264
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool startRecording(const std::vector<uint32_t> &cameras, const std::string &directory, const std::string &format);
+
+    /**
+     * @brief Stop of a disk recording
+     *
+     * @param cameras camera indices, empty stops every recording
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool stopRecording(const std::vector<uint32_t> &cameras);
+
+    /**
+     * @brief Query of camera count
+     * @details This API returns the number of cameras opened by the last
+     * successful start request
+     *
+     * @return number of active cameras
+     */
+    uint32_t getCameraCount() const
     {
-      m_cameraPub = *pub;
+      return m_cameraCount;
     }
 
+    /**
+     * @brief Query of captured frames
+     *
+     * @param index camera index
+     *
+     * @return number of frames read from the camera since it was started
+     */
+    uint64_t getCapturedCount(uint32_t index) const
+    {
+      return m_counters[index].captured.load();
+    }
+
+    /**
+     * @brief Collection of the pipeline statistics
+     * @details Fills one status per camera and one per output with frame
+     * rates, drop counters and stage durations since the previous
+     * collection, then resets the stage histograms. The same statistics are
+     * published on /diagnostics every ~stats_period seconds, so a caller
+     * collecting on its own sets ~stats_period to 0.
+     *
+     * @param diagnostics receives the statistics
+     */
+    virtual void collectStats(diagnostic_msgs::DiagnosticArray &diagnostics);
+
     /**
      * @brief Query of Sensor state
      * @details This API is required to quesy the camera sensor state
@@ -102,32 +297,278 @@ namespace nv
      * @return true if dta acquisition from camera sensor is active
      *         false otherwise
      */
-    bool isSensorsRunning()
+    virtual bool isSensorsRunning() const
     {
       return m_cameraRun;
     }
 
   private:
-    void run_camera();
+    /**
+     * @struct CameraOutput
+     * @brief Streaming and publishing state of one transformed camera output
+     * @details Every output owns its streamer targets, streamer, message pool
+     * and receive and publish stages, so a slow subscriber of one output does
+     * not hold back the others.
+     */
+    struct CameraOutput
+    {
+      /** Size and crop of the output. */
+      OutputConfig config;
+      /** Crop of the camera frame read by the transformation. */
+      dwRect roi{0, 0, 0, 0};
+      /** Size of the published frames. */
+      uint32_t width = 0;
+      uint32_t height = 0;
+      /** False if the output is the unmodified converted frame. */
+      bool transform = false;
+      /** 2 or 4 if the native frame is converted and resized by one specialized kernel (~fused_convert), 0 otherwise. */
+      int fusedScale = 0;
+      TensorSourceFormat fusedFormat = TENSOR_SOURCE_YUV420;
+
+      dwImageStreamerHandle_t streamer = DW_NULL_HANDLE;
+      /** Streamer targets (~streamer_depth), EGL_STREAM_FRAMES more for output-domain=cuda. */
+      dwImageHandle_t streamImage[MAX_STREAMER_TARGETS] = {DW_NULL_HANDLE};
+      uint32_t streamTargets = 0;
+      /** Targets not in flight, owned by the convert stage. Filled from dwImageStreamer_producerReturn(),
+       *  which hands them back in the order the receive stage returned them. */
+      dwImageHandle_t streamFree[MAX_STREAMER_TARGETS] = {DW_NULL_HANDLE};
+      uint32_t streamFreeCount = 0;
+      /** Frames sent to the streamer, owned by the convert stage. */
+      uint64_t streamSent = 0;
+      /** Frames received from the streamer, owned by the receive stage. */
+      uint64_t streamReceived = 0;
+      /** Frames offered to the output and sensor timestamp of the last converted one, for @<Hz> and /<N>. */
+      uint64_t offered = 0;
+      dwTime_t lastConverted = 0;
+      /** PipelineClock time in us each target was sent at, targets are received in sending order. */
+      std::atomic<int64_t> sendTime[MAX_STREAMER_TARGETS];
+      /** Sensor frame number of each target. */
+      std::atomic<uint32_t> sendSeq[MAX_STREAMER_TARGETS];
+
+      /** output-domain=cuda, frames presented on the EGLStream until the consumer hands them back. */
+      EglStreamProducer eglProducer;
+      dwImageHandle_t cudaPending[MAX_STREAMER_TARGETS] = {DW_NULL_HANDLE};
+      uint32_t cudaPendingCount = 0;
+
+      ImagePool imagePool;
+      FrameRing<sensor_msgs::Image *> publishRing;
+      /** backpressure=..., what the receive stage does while the publish ring is full. */
+      BackpressureConfig backpressure;
+      OutputCounters counters;
+      OutputStats stats;
+      /** Frames published at the previous statistics collection. */
+      uint64_t statsPublished = 0;
+
+      std::thread receiveThread;
+      std::thread publishThread;
+
+      ros::Publisher cameraPub;
+      ros::Publisher cudaPub;
+      /** Frames in shared memory for the image_transport "shm" transport, descriptors on <topic>/shm. */
+      ShmRing shmRing;
+      ros::Publisher shmPub;
+      /** rectify=true, pinhole intrinsics of the output published on <topic>/camera_info with every frame. */
+      sensor_msgs::CameraInfo cameraInfo;
+      ros::Publisher infoPub;
+      std::string topic;
+      std::string socketPath;
+    };
+
+    /**
+     * @struct GroupBatch
+     * @brief Images of one group capture collected from the sibling publish stages
+     */
+    struct GroupBatch
+    {
+      std::mutex mutex;
+      // siblings of one capture share their frame number
+      uint32_t seq = 0;
+      sensor_msgs::ImageConstPtr images[MAX_CAMERAS];
+      uint32_t count = 0;
+      ros::Publisher publisher;
+      std::string topic;
+    };
+
+    /**
+     * @struct GroupPass
+     * @brief Frames of all siblings read in one capture pass of a group with a tensor
+     * @details Passes are taken from a pool of ~ring_depth + 2 per group, so the
+     * capture stage always finds a free one while the ring is full and the
+     * convert stage holds another.
+     */
+    struct GroupPass
+    {
+      /** DW_NULL_HANDLE for a sibling whose read timed out. */
+      dwCameraFrameHandle_t frames[MAX_CAMERAS];
+      dwTime_t timestamp = 0;
+      uint32_t seq = 0;
+      std::atomic<bool> busy{false};
+    };
+
+    /**
+     * @struct CaptureSlot
+     * @brief A captured frame queued to the convert stage by its index
+     * @details Slots are taken from a pool of ~ring_depth + 2 per camera, as
+     * the passes of a group. The convert stage copies the frame out and frees
+     * the slot right after the pop.
+     */
+    struct CaptureSlot
+    {
+      CapturedFrame captured{DW_NULL_HANDLE, 0, 0};
+      std::atomic<bool> busy{false};
+    };
+
+    bool forEachCamera(bool masters, const std::function<bool(uint32_t)> &step);
+    bool createCamera(uint32_t index, dwSensorParams params, const CameraConfig &config);
+    bool startCamera(uint32_t index);
+    bool startPipeline(uint32_t index);
+    void releasePipeline(uint32_t index);
+    void advertiseOutputs(uint32_t index);
+    void startPipelineThreads(uint32_t index);
+    void stopPipelineThreads(uint32_t index);
+    bool isConversionDue(uint32_t index, dwTime_t timestamp);
+    bool hasSubscribers(uint32_t index, uint32_t output);
+    bool isOutputDue(uint32_t index, uint32_t output, dwTime_t timestamp);
+
+    // the convert, receive and publish stages of a camera stop for a reconfiguration
+    bool isPipelineRunning(uint32_t index) const
+    {
+      return m_cameraRun && m_pipelineRun[index];
+    }
+    bool prepareCameras(dwSensorParams params);
+    bool isPreparedFor(const dwSensorParams &params) const;
+    bool runCameras();
+    bool armCamera(uint32_t index);
+    void abortRun();
+    void releasePrepared();
+    void backoff(int64_t us);
+    uint32_t nextSequence(uint32_t index, dwTime_t timestamp);
+    void pushFrame(uint32_t index, dwCameraFrameHandle_t frame, dwTime_t timestamp, uint32_t seq,
+                   const PipelineClock::time_point &start);
+    bool captureGroup(uint32_t index);
+    GroupPass *acquirePass(uint32_t index);
+    bool popCaptured(uint32_t index, CapturedFrame &captured, int64_t timeoutUs);
+    void releasePass(GroupPass *pass, uint32_t siblings);
+    bool convertPass(uint32_t index, const GroupPass &pass);
+    bool convertTensor(uint32_t index, const dwCameraFrameHandle_t *frames, dwTime_t timestamp, uint32_t seq);
+    void offerGroupImage(uint32_t index, const sensor_msgs::ImageConstPtr &image);
+    bool startOutput(uint32_t index, uint32_t output, dwImageProperties imageProperties);
+    void resetOutput(uint32_t index, uint32_t output);
+    void releaseCamera(uint32_t index);
+    void releaseOutput(uint32_t index, uint32_t output);
+    void drainOutput(uint32_t index, uint32_t output);
+    bool convertFrame(uint32_t index, const CapturedFrame &captured);
+    bool receiveFrame(uint32_t index, uint32_t output, dwImageHandle_t cpuFrame, uint32_t seq);
+    bool receiveCudaFrame(uint32_t index, uint32_t output, dwImageHandle_t cudaFrame, uint32_t seq);
+    bool waitPublishRing(uint32_t index, uint32_t output);
+    bool convertFused(uint32_t index, uint32_t output, dwImageHandle_t source, dwImageHandle_t target);
+    void publishShm(uint32_t index, uint32_t output, const dwImageCPU *imgCPU, const dwImageProperties &prop,
+                    dwTime_t timestamp, uint32_t seq);
+    bool hasImageSubscribers(uint32_t index, uint32_t output);
+    void initCameraInfo(uint32_t index, uint32_t output);
+    void publishCameraInfo(uint32_t index, uint32_t output, dwTime_t timestamp, uint32_t seq);
+    void reclaimCudaFrames(uint32_t index, uint32_t output);
+    void recordLatency(uint32_t index, uint32_t output, dwTime_t timestamp);
+
+    // pipeline stages, capture -> convert -> receive -> publish, connected by
+    // FrameRing and, between convert and the receive stage of every output,
+    // by the image streamer of the output. A group with a tensor has a single
+    // convert stage converting the whole pass.
+    void run_capture(uint32_t index);
+    void run_convert(uint32_t index);
+    void run_convertGroup(uint32_t index);
+    void run_receive(uint32_t index, uint32_t output);
+    void run_publish(uint32_t index, uint32_t output);
 
-    dwContextHandle_t m_sdk = DW_NULL_HANDLE;
-    dwSALHandle_t m_hal = DW_NULL_HANDLE;
     dwSensorHandle_t m_cameraSensor = DW_NULL_HANDLE;
-    dwSensorHandle_t m_cameraMaster;
-    dwSensorHandle_t m_camera[16];
-    dwImageHandle_t m_rgbaFrame[16] = {DW_NULL_HANDLE};
-    // Frame grab variables
-    dwImageStreamerHandle_t m_streamerNvmediaToCpuProcessed[16] = {DW_NULL_HANDLE};
+    dwSensorHandle_t m_camera[MAX_CAMERAS] = {DW_NULL_HANDLE};
+
+    // synchronized groups, every sibling of a sensor occupies one camera slot sharing its handle
+    uint32_t m_cameraMaster[MAX_CAMERAS] = {0};
+    uint32_t m_sibling[MAX_CAMERAS] = {0};
+    uint32_t m_groupSize[MAX_CAMERAS] = {0};
+    uint32_t m_groupCount = 0;
+    // indexed by the slot of the group master
+    GroupBatch m_groupBatch[MAX_CAMERAS];
+    // tensor=..., all frames of a capture converted by one kernel launch, indexed by the master
+    GroupTensor m_tensor[MAX_CAMERAS];
+    // passes of a group with a tensor, converted together by the convert stage of the master
+    std::unique_ptr<GroupPass[]> m_groupPass[MAX_CAMERAS];
+    uint32_t m_groupPassCount[MAX_CAMERAS] = {0};
+    FrameRing<GroupPass *> m_groupRing[MAX_CAMERAS];
+    // output format at full size, only when the transformations read a converted frame
+    dwImageHandle_t m_convertedFrame[MAX_CAMERAS] = {DW_NULL_HANDLE};
+    // rectify=true, the outputs read the undistorted converted frame
+    CameraRectifier m_rectifier[MAX_CAMERAS];
+    // rig file holding the camera models of the rig sensors (~rig)
+    std::string m_rigPath;
+
+    CameraConfig m_config[MAX_CAMERAS];
+
+    // encoder=h264|h265, native frames compressed by the hardware encoder
+    CameraEncoder m_encoder[MAX_CAMERAS];
+    // record_start service, frames written to disk by the serializer thread
+    CameraRecorder m_recorder[MAX_CAMERAS];
+
+    // transformed outputs (output=...), all read the same conversion
+    CameraOutput m_output[MAX_CAMERAS][MAX_OUTPUTS];
+    uint32_t m_outputCount[MAX_CAMERAS] = {0};
+    dwImageTransformationHandle_t m_imageTransformationEngine[MAX_CAMERAS] = {DW_NULL_HANDLE};
+
+    // streamer targets per output (~streamer_depth)
+    int m_streamerDepth = 2;
+
+    // convert, stream and fill an output only while it has subscribers (~lazy)
+    bool m_lazy = true;
+    // start the sensors of a request on one thread per master (~parallel_start)
+    bool m_parallelStart = true;
+    // publish straight from the streamer CPU buffer (~zero_copy)
+    bool m_zeroCopy = false;
+    // convert and resize native CUDA frames to 1/2 and 1/4 in one kernel (~fused_convert)
+    bool m_fusedConvert = true;
+    // number of pooled messages which may be in flight per output (~pool_depth)
+    int m_poolDepth = 4;
+    // slots of the shared-memory ring per output, 0 without the shm transport (~shm_slots)
+    int m_shmSlots = ShmRing::DEFAULT_SLOT_COUNT;
+
+    // capacity of the rings between the pipeline stages (~ring_depth)
+    int m_ringDepth = 2;
+    FrameRing<uint32_t> m_captureRing[MAX_CAMERAS];
+    std::unique_ptr<CaptureSlot[]> m_captureSlot[MAX_CAMERAS];
+    uint32_t m_captureSlotCount[MAX_CAMERAS] = {0};
+    CameraCounters m_counters[MAX_CAMERAS];
+    // read timeouts from the sensor frame rate, state of the read loop
+    CaptureHealth m_health[MAX_CAMERAS];
+    // frame numbering owned by the capture stage, the master numbers all siblings of a group
+    uint32_t m_nextSequence[MAX_CAMERAS] = {0};
+    dwTime_t m_lastStamp[MAX_CAMERAS] = {0};
+
+    // fixed capture rate in Hz (~capture_rate), 0 reads frames as fast as the sensor delivers them
+    double m_captureRate = 0.0;
+    CameraStats m_stats[MAX_CAMERAS];
+    uint64_t m_statsCaptured[MAX_CAMERAS] = {0};
 
-    float m_shrinkFactor = 2.0f;
-    dwImageHandle_t m_imageResized = DW_NULL_HANDLE;
-    dwImageTransformationHandle_t m_imageTransformationEngine = DW_NULL_HANDLE;
+    // mlockall() before the first start (~lock_memory)
+    bool m_memoryLocked = false;
 
-    bool m_cameraRun = false;
+    uint32_t m_cameraCount = 0;
+    // cameras allocated for the start request m_preparedProtocol / m_preparedParams
+    bool m_prepared = false;
+    // prepared by prepare(), kept across stop()
+    bool m_keepPrepared = false;
+    std::string m_preparedProtocol;
+    std::string m_preparedParams;
+    std::atomic<bool> m_cameraRun{false};
+    std::atomic<bool> m_pipelineRun[MAX_CAMERAS];
+    // sensor timestamp of the last converted frame, for publish-rate
+    dwTime_t m_lastConverted[MAX_CAMERAS] = {0};
 
-    std::thread m_cameraThread;
+    std::thread m_cameraThread[MAX_CAMERAS];
+    std::thread m_convertThread[MAX_CAMERAS];
 
-    ros::Publisher m_cameraPub;
+    std::string m_topic[MAX_CAMERAS];
+    std::string m_frameId[MAX_CAMERAS];
+    std::string m_socketPath[MAX_CAMERAS];
   };
 
 } // namespace nv
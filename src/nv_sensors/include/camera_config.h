@@ -0,0 +1,288 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_CAMERA_CONFIG_H_
+#define _NV_SENSORS_CAMERA_CONFIG_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file camera_config.h
+ *
+ * @brief Declaration of the per camera output options which are given
+ * together with the Driveworks sensor parameters of a start request.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   *  @brief Declares where converted frames are delivered to.
+   */
+  typedef enum _OutputDomain {
+
+    /** Frames are streamed to the CPU and published as sensor_msgs/Image. */
+    OUTPUT_DOMAIN_CPU = 0,
+
+    /** Frames are streamed to CUDA and shared with co-located consumers over an EGLStream. */
+    OUTPUT_DOMAIN_CUDA = 1,
+
+  } OutputDomain;
+
+  /**
+   *  @brief Declares the pixel encoding of published frames.
+   */
+  typedef enum _OutputEncoding {
+
+    /** Interleaved 8 bit RGBA, 4 bytes per pixel. */
+    OUTPUT_ENCODING_RGBA8 = 0,
+
+    /** Interleaved 8 bit RGB, 3 bytes per pixel. */
+    OUTPUT_ENCODING_RGB8 = 1,
+
+    /** Interleaved 8 bit BGR, 3 bytes per pixel. */
+    OUTPUT_ENCODING_BGR8 = 2,
+
+    /** 8 bit luminance, 1 byte per pixel. */
+    OUTPUT_ENCODING_MONO8 = 3,
+
+    /** Planar YUV 4:2:0 (I420), 1.5 bytes per pixel. */
+    OUTPUT_ENCODING_YUV420 = 4,
+
+    /** Semi-planar YUV 4:2:0 (NV12), 1.5 bytes per pixel. */
+    OUTPUT_ENCODING_NV12 = 5,
+
+    /** The native processed format of the sensor, resolved to YUV420 or NV12 when the camera starts. */
+    OUTPUT_ENCODING_NATIVE = 6,
+
+  } OutputEncoding;
+
+  /**
+   *  @brief Declares the codec of the hardware encoded output.
+   */
+  typedef enum _VideoCodec {
+
+    /** No encoded output. */
+    VIDEO_CODEC_NONE = 0,
+
+    /** H.264 packets published on <topic>/h264. */
+    VIDEO_CODEC_H264 = 1,
+
+    /** H.265 packets published on <topic>/h265. */
+    VIDEO_CODEC_H265 = 2,
+
+  } VideoCodec;
+
+  /**
+   *  @brief Declares the memory layout of the batched tensor of a camera group.
+   */
+  typedef enum _TensorLayout {
+
+    /** No tensor output. */
+    TENSOR_LAYOUT_NONE = 0,
+
+    /** Camera, channel, row, column; one plane per color channel. */
+    TENSOR_LAYOUT_NCHW = 1,
+
+    /** Camera, row, column, channel; interleaved RGB. */
+    TENSOR_LAYOUT_NHWC = 2,
+
+  } TensorLayout;
+
+  /**
+   *  @brief Declares the element type of the batched tensor.
+   */
+  typedef enum _TensorDataType {
+
+    /** 8 bit RGB values. */
+    TENSOR_DATA_TYPE_UINT8 = 0,
+
+    /** 32 bit float RGB values, normalized with the tensor mean and standard deviation. */
+    TENSOR_DATA_TYPE_FLOAT32 = 1,
+
+    /** 16 bit float RGB values, normalized as TENSOR_DATA_TYPE_FLOAT32. */
+    TENSOR_DATA_TYPE_FLOAT16 = 2,
+
+  } TensorDataType;
+
+  /**
+   *  @brief Declares what the receive stage does with a frame while the publish ring of an output is full.
+   */
+  typedef enum _BackpressurePolicy {
+
+    /** The oldest queued frame is dropped, subscribers get the latest frames. */
+    BACKPRESSURE_DROP_OLDEST = 0,
+
+    /** The new frame is dropped, the queued frames are published in full. */
+    BACKPRESSURE_DROP_NEWEST = 1,
+
+    /** The receive stage waits for the publish stage up to a deadline, then drops the new frame. */
+    BACKPRESSURE_BLOCK = 2,
+
+  } BackpressurePolicy;
+
+  /** Maximum number of transformed outputs of one camera. */
+  static const uint32_t MAX_CAMERA_OUTPUTS = 4;
+
+  /**
+   * @struct OutputConfig
+   * @brief One transformed output of a camera
+   * @details Written as output=<name>[:<width>x<height>[:<crop width>x<crop height>+<x>+<y>]][@<Hz>|/<N>],
+   * e.g. "output=thumb:480x302" or "output=roi:960x604:1920x1208+960+0".
+   * Every output is published on <topic>/<name>. A trailing @<Hz> limits the
+   * rate of the output, /<N> publishes every N-th frame, e.g. "output=lanes:480x302@5".
+   */
+  struct OutputConfig
+  {
+    /** topic suffix, empty for the default output published on the camera topic */
+    std::string name;
+
+    /** output size in pixels, 0 keeps the size of the crop */
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    /** crop of the camera frame, a crop size of 0 keeps the full frame */
+    uint32_t cropX = 0;
+    uint32_t cropY = 0;
+    uint32_t cropWidth = 0;
+    uint32_t cropHeight = 0;
+
+    /** @<Hz>, maximum rate of the output, 0 follows the camera */
+    float rate = 0.0f;
+
+    /** /<N>, every N-th frame of the camera is published, 1 publishes all */
+    uint32_t decimation = 1;
+  };
+
+  /**
+   * @struct BackpressureConfig
+   * @brief Backpressure policy of one output
+   * @details Written as backpressure=[<output>:]drop-oldest|drop-newest|block[:<ms>],
+   * e.g. "backpressure=drop-newest" for all outputs or "backpressure=lanes:block:20".
+   * Without a name the policy applies to every output not named by another
+   * entry. The deadline of block defaults to one frame period.
+   */
+  struct BackpressureConfig
+  {
+    /** output name, empty for all outputs */
+    std::string output;
+
+    BackpressurePolicy policy = BACKPRESSURE_DROP_OLDEST;
+
+    /** :<ms>, longest wait of the receive stage with block, 0 waits one frame period */
+    uint32_t deadlineMs = 0;
+  };
+
+  /**
+   * @struct CameraConfig
+   * @brief Output options of one camera
+   * @details The options are written as key=value pairs in the same comma
+   * separated list as the Driveworks sensor parameters, e.g.
+   * "camera-name=SF3324,interface=csi-a,link=0,output-domain=cuda".
+   * They are removed from the list before the sensor is created.
+   */
+  struct CameraConfig
+  {
+    /** frame-id=<id>, frame id of the published headers, the siblings of a group append _<sibling> */
+    std::string frameId;
+
+    /** output-domain=cpu|cuda */
+    OutputDomain outputDomain = OUTPUT_DOMAIN_CPU;
+
+    /** output-encoding=rgba8|rgb8|bgr8|mono8|yuv420|nv12|native, only rgba8 with output-domain=cuda */
+    OutputEncoding outputEncoding = OUTPUT_ENCODING_RGBA8;
+
+    /** encoder=h264|h265 */
+    VideoCodec videoCodec = VIDEO_CODEC_NONE;
+
+    /** encoder-bitrate=<bits per second> */
+    uint32_t encoderBitrate = 8000000;
+
+    /** encoder-gop=<frames between key frames> */
+    uint32_t encoderGop = 30;
+
+    /** encoder-framerate=<frames per second> */
+    uint32_t encoderFramerate = 30;
+
+    /** raw-output=true|false, false publishes the encoded output only */
+    bool rawOutput = true;
+
+    /** publish-rate=<Hz>, frames beyond the rate are not converted, 0 converts every frame */
+    float publishRate = 0.0f;
+
+    /** tensor=nchw|nhwc, all frames of a capture converted into one RGB tensor */
+    TensorLayout tensorLayout = TENSOR_LAYOUT_NONE;
+
+    /** tensor-type=uint8|float32|float16 */
+    TensorDataType tensorDataType = TENSOR_DATA_TYPE_UINT8;
+
+    /** tensor-mean=<r>:<g>:<b> and tensor-std=<r>:<g>:<b>, float tensors hold (value / 255 - mean) / std */
+    float tensorMean[3] = {0.0f, 0.0f, 0.0f};
+    float tensorStd[3] = {1.0f, 1.0f, 1.0f};
+
+    /** tensor-order=rgb|bgr, channel order of the tensor */
+    bool tensorBgr = false;
+
+    /** tensor-size=<width>x<height>, 0 keeps the size of the camera frames */
+    uint32_t tensorWidth = 0;
+    uint32_t tensorHeight = 0;
+
+    /** rectify=true|false, outputs crop and resize the undistorted frame, requires rig-sensor and rgba8 */
+    bool rectify = false;
+
+    /** rectify-fov=<degrees>, horizontal field of view of the rectified frame, 0 keeps the lens up to 120 */
+    float rectifyFov = 0.0f;
+
+    /** rig-sensor=<name>, sensor of the rig holding the camera model, set for the cameras of ~rig */
+    std::string rigSensor;
+
+    /** output=..., up to MAX_CAMERA_OUTPUTS, none publishes the frame at half size on the camera topic */
+    std::vector<OutputConfig> outputs;
+
+    /** backpressure=..., policies of the publish rings, a later entry for the same output wins */
+    std::vector<BackpressureConfig> backpressure;
+  };
+
+  /**
+   * @brief Parsing of the camera output options
+   * @details Splits a sensor parameter list into the options understood by
+   * SensorCamera and the parameters forwarded to Driveworks.
+   *
+   * @param params comma separated key=value list of a start request
+   * @param config receives the parsed output options
+   * @param sensorParams receives the remaining Driveworks sensor parameters
+   *
+   * @return true if all options are valid
+   *         false otherwise
+   */
+  bool parseCameraConfig(const std::string &params, CameraConfig &config, std::string &sensorParams);
+
+  /**
+   * @brief Lookup of the backpressure policy of an output
+   *
+   * @param config parsed options of the camera
+   * @param output output name, empty for the default output
+   *
+   * @return the entry naming the output, else the one without a name, else drop-oldest
+   */
+  BackpressureConfig findBackpressure(const CameraConfig &config, const std::string &output);
+
+  /** @return name of a backpressure policy as written in the options */
+  const char *getBackpressureName(BackpressurePolicy policy);
+
+} // namespace nv
+
+#endif // _NV_SENSORS_CAMERA_CONFIG_H_
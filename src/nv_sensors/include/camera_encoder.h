@@ -0,0 +1,139 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_CAMERA_ENCODER_H_
+#define _NV_SENSORS_CAMERA_ENCODER_H_
+
+#include <dw/sensors/Sensors.h>
+#include <dw/sensors/camera/Camera.h>
+#include <dw/sensors/SensorSerializer.h>
+
+#include <ros/ros.h>
+
+#include "camera_config.h"
+#include "frame_stamp_queue.h"
+#include "time_mapper.h"
+#include "video_packet.h"
+
+#include <string>
+
+/**
+ * @file camera_encoder.h
+ *
+ * @brief Declaration of the hardware video encoder output of a camera.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @class CameraEncoder
+   * @brief Publishes H.264/H.265 packets encoded by the NvMedia encoder
+   * @details The encoder is a Driveworks sensor serializer with a user
+   * sink. Native camera frames are queued with encode() and compressed on
+   * the serializer thread by the hardware encoder, so neither the GPU
+   * conversion nor the CPU is involved. Every packet is published as
+   * sensor_msgs/CompressedImage with format h264 or h265 on
+   * <topic>/h264 or <topic>/h265.
+   */
+  class CameraEncoder
+  {
+
+  public:
+    ~CameraEncoder();
+
+    /**
+     * @brief Initialization of the encoder
+     * @details Creates the serializer of the camera and advertises the
+     * packet topic, start() starts the serializer thread.
+     *
+     * @param camera started or stopped camera sensor handle
+     * @param config output options holding codec, bitrate, GOP and frame rate
+     * @param nh ros::NodeHandle used for advertising
+     * @param topic raw image topic of the camera, the codec name is appended
+     * @param frameId frame id of the packet header
+     * @param clock maps the sensor timestamps to packet stamps, must outlive the encoder
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool initialize(dwSensorHandle_t camera, const CameraConfig &config, ros::NodeHandle &nh,
+                    const std::string &topic, const std::string &frameId, const TimeMapper &clock);
+
+    /**
+     * @brief Start of the serializer thread
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool start();
+
+    /**
+     * @brief Stop of the serializer thread
+     * @details Encodes the queued frames, the encoder may be started again.
+     * Must be called before the camera sensor is stopped.
+     */
+    void stop();
+
+    /**
+     * @brief Release of the encoder
+     * @details Stops the serializer thread, must be called before the camera
+     * sensor is released.
+     */
+    void release();
+
+    /**
+     * @brief Queueing of a camera frame
+     * @details The frame is handed to the serializer, it may be returned to
+     * the camera as soon as this function returns. The packets of the frame,
+     * and the parameter sets before it, carry the stamp and sequence number
+     * of the frame, packets are matched to frames by the slices which start
+     * a frame (classifyVideoPacket()). A frame is skipped while
+     * FrameStampQueue::CAPACITY frames wait for their packets.
+     *
+     * @param frame camera frame read from the sensor
+     * @param seq sequence number of the frame
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool encode(dwCameraFrameHandle_t frame, uint32_t seq);
+
+    /** @return true if the encoder was initialized */
+    bool isEnabled() const
+    {
+      return m_serializer != DW_NULL_HANDLE;
+    }
+
+  private:
+    static void onData(const uint8_t *data, size_t size, void *userData);
+
+    dwSensorSerializerHandle_t m_serializer = DW_NULL_HANDLE;
+    bool m_started = false;
+    ros::Publisher m_publisher;
+    std::string m_format;
+    std::string m_frameId;
+    const TimeMapper *m_clock = nullptr;
+
+    // the encoder emits the packets in queueing order, a frame may be preceded by headers and split
+    FrameStampQueue m_queued;
+
+    // owned by the serializer thread, stamp of the frame the last packet started
+    dwTime_t m_timestamp = 0;
+    uint32_t m_seq = 0;
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_CAMERA_ENCODER_H_
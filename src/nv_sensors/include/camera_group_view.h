@@ -0,0 +1,113 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_CAMERA_GROUP_VIEW_H_
+#define _NV_SENSORS_CAMERA_GROUP_VIEW_H_
+
+#include <sensor_msgs/Image.h>
+#include <ros/serialization.h>
+
+#include "nv_sensors/CameraGroup.h"
+
+/**
+ * @file camera_group_view.h
+ *
+ * @brief Declaration of a non-owning camera group message which is
+ * serialized on the wire exactly like nv_sensors/CameraGroup.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @struct CameraGroupView
+   * @brief A nv_sensors/CameraGroup whose images are borrowed from the image pools
+   * @details As ImageView, the view only points at the pooled sibling
+   * images, which are serialized straight from the pool inside
+   * ros::Publisher::publish(), so a batch is never copied into a
+   * std::vector<sensor_msgs::Image>. The images only have to stay valid
+   * until publish() returns.
+   */
+  struct CameraGroupView
+  {
+    std_msgs::Header header;
+
+    /** Borrowed sibling images, count entries. */
+    const sensor_msgs::ImageConstPtr *images = nullptr;
+    uint32_t count = 0;
+  };
+
+} // namespace nv
+
+namespace ros
+{
+  namespace message_traits
+  {
+    template <>
+    struct MD5Sum<nv::CameraGroupView>
+    {
+      static const char *value() { return MD5Sum<nv_sensors::CameraGroup>::value(); }
+      static const char *value(const nv::CameraGroupView &) { return value(); }
+    };
+
+    template <>
+    struct DataType<nv::CameraGroupView>
+    {
+      static const char *value() { return DataType<nv_sensors::CameraGroup>::value(); }
+      static const char *value(const nv::CameraGroupView &) { return value(); }
+    };
+
+    template <>
+    struct Definition<nv::CameraGroupView>
+    {
+      static const char *value() { return Definition<nv_sensors::CameraGroup>::value(); }
+      static const char *value(const nv::CameraGroupView &) { return value(); }
+    };
+
+    template <>
+    struct HasHeader<nv::CameraGroupView> : TrueType
+    {
+    };
+  } // namespace message_traits
+
+  namespace serialization
+  {
+    template <>
+    struct Serializer<nv::CameraGroupView>
+    {
+      template <typename Stream>
+      inline static void write(Stream &stream, const nv::CameraGroupView &m)
+      {
+        stream.next(m.header);
+        stream.next(m.count);
+        for (uint32_t s = 0; s < m.count; ++s)
+        {
+          stream.next(*m.images[s]);
+        }
+      }
+
+      inline static uint32_t serializedLength(const nv::CameraGroupView &m)
+      {
+        uint32_t size = serializationLength(m.header) + sizeof(uint32_t);
+        for (uint32_t s = 0; s < m.count; ++s)
+        {
+          size += serializationLength(*m.images[s]);
+        }
+        return size;
+      }
+    };
+  } // namespace serialization
+} // namespace ros
+
+#endif // _NV_SENSORS_CAMERA_GROUP_VIEW_H_
@@ -0,0 +1,180 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_CAMERA_RECORDER_H_
+#define _NV_SENSORS_CAMERA_RECORDER_H_
+
+#include <dw/sensors/Sensors.h>
+#include <dw/sensors/camera/Camera.h>
+#include <dw/sensors/SensorSerializer.h>
+
+#include "camera_config.h"
+#include "frame_stamp_queue.h"
+#include "video_packet.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+/**
+ * @file camera_recorder.h
+ *
+ * @brief Declaration of the in-process disk recording of a camera.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @struct RecordIndexEntry
+   * @brief One entry of the index file of a recording, 32 bytes in host byte order
+   * @details One entry per frame. The bytes of an entry are the encoder
+   * packets of the frame, starting with the parameter sets written before
+   * it. A raw recording has one packet per frame.
+   */
+  struct RecordIndexEntry
+  {
+    /** Sensor timestamp in us of the frame. */
+    int64_t timestamp;
+    /** Segment file the frame starts in. */
+    uint32_t segment;
+    uint32_t reserved;
+    /** Offset of the frame in its segment, a frame may continue in the next segment. */
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  /**
+   * @class CameraRecorder
+   * @brief Records the frames of a camera to disk without the ROS transport
+   * @details The recorder is a Driveworks sensor serializer with a user
+   * sink, as the encoder output. Native frames are queued with record() and
+   * encoded (h264, h265) or serialized unmodified (raw) on the serializer
+   * thread, which copies the packets into preallocated, memory-mapped
+   * segment files <prefix>_<n>.<format> of a fixed size. Segments are
+   * consecutive parts of one stream and written back to disk while they
+   * fill, every packet gets an entry in the index file <prefix>.idx. A
+   * recording is started and stopped while the camera is running.
+   */
+  class CameraRecorder
+  {
+
+  public:
+    /** Default size of one segment file. */
+    static const uint64_t DEFAULT_SEGMENT_SIZE = 256ULL << 20;
+
+    ~CameraRecorder();
+
+    /**
+     * @brief Start of a recording
+     * @details Creates the serializer of the camera and the first segment
+     * and index files, and starts the serializer thread.
+     *
+     * @param camera started camera sensor handle
+     * @param config options of the camera, bitrate, GOP and frame rate are shared with the encoder
+     * @param prefix path of the files without extension, e.g. /data/cameraData
+     * @param format h264, h265 or raw
+     * @param segmentSize size of one segment file, rounded up to whole pages
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool start(dwSensorHandle_t camera, const CameraConfig &config, const std::string &prefix,
+               const std::string &format, uint64_t segmentSize);
+
+    /**
+     * @brief Stop of a recording
+     * @details Flushes the serializer, trims the last segment to its data and
+     * closes all files. Must be called before the camera sensor is released.
+     */
+    void stop();
+
+    /**
+     * @brief Queueing of a camera frame
+     * @details Never blocks, a frame queued while the recording is started
+     * or stopped, or while FrameStampQueue::CAPACITY frames wait for their
+     * packets, is counted as dropped. The frame may be returned to the
+     * camera as soon as this function returns.
+     *
+     * @param frame camera frame read from the sensor
+     */
+    void record(dwCameraFrameHandle_t frame);
+
+    /** @return true while a recording is running */
+    bool isRecording() const
+    {
+      return m_recording.load(std::memory_order_relaxed);
+    }
+
+    /** @return frames queued since the recording was started */
+    uint64_t getFrames() const
+    {
+      return m_frames.load(std::memory_order_relaxed);
+    }
+
+    /** @return bytes written since the recording was started */
+    uint64_t getBytes() const
+    {
+      return m_bytes.load(std::memory_order_relaxed);
+    }
+
+    /** @return frames not recorded since the recording was started */
+    uint64_t getDropped() const
+    {
+      return m_dropped.load(std::memory_order_relaxed);
+    }
+
+  private:
+    static void onData(const uint8_t *data, size_t size, void *userData);
+    void write(const uint8_t *data, size_t size);
+    bool writeEntry();
+    bool openSegment();
+    void closeSegment();
+    void flushSegment(bool all);
+
+    // guards the serializer between the convert stage and start()/stop()
+    std::mutex m_mutex;
+    dwSensorSerializerHandle_t m_serializer = DW_NULL_HANDLE;
+    std::atomic<bool> m_recording{false};
+
+    std::string m_prefix;
+    std::string m_format;
+    uint64_t m_segmentSize = DEFAULT_SEGMENT_SIZE;
+
+    // owned by the serializer thread while recording
+    int m_fd = -1;
+    uint8_t *m_mapping = nullptr;
+    uint32_t m_segment = 0;
+    uint64_t m_used = 0;
+    uint64_t m_flushed = 0;
+    FILE *m_index = nullptr;
+    bool m_failed = false;
+    // the frame being written, its entry is written once the next frame starts or the recording stops
+    RecordIndexEntry m_entry{};
+    bool m_entryOpen = false;
+    // parameter sets written since, they are part of the entry of the frame they precede
+    RecordIndexEntry m_header{};
+
+    // the serializer emits the packets in queueing order, a frame may be preceded by headers and split
+    FrameStampQueue m_queued;
+    std::atomic<uint64_t> m_frames{0};
+    std::atomic<uint64_t> m_bytes{0};
+    std::atomic<uint64_t> m_dropped{0};
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_CAMERA_RECORDER_H_
@@ -0,0 +1,128 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_CAMERA_RECTIFIER_H_
+#define _NV_SENSORS_CAMERA_RECTIFIER_H_
+
+#include <dw/core/Context.h>
+#include <dw/image/Image.h>
+#include <dw/interop/streamer/ImageStreamer.h>
+#include <dw/calibration/cameramodel/CameraModel.h>
+#include <dw/imageprocessing/geometry/rectifier/Rectifier.h>
+
+#include "camera_config.h"
+
+#include <string>
+
+/**
+ * @file camera_rectifier.h
+ *
+ * @brief Declaration of the GPU lens undistortion of a camera.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @struct PinholeIntrinsics
+   * @brief Intrinsics of the ideal pinhole camera a frame is rectified to, in pixels
+   */
+  struct PinholeIntrinsics
+  {
+    float focalX = 0.0f;
+    float focalY = 0.0f;
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+  };
+
+  /**
+   * @class CameraRectifier
+   * @brief Removes the lens distortion of the full size RGBA frame of a camera
+   * @details The camera model of the rig sensor is mapped onto an ideal
+   * pinhole camera of the same size by a Driveworks rectifier, whose
+   * distortion map is computed once on the GPU at initialization. Every
+   * frame is then a single remap kernel, the outputs of the camera crop and
+   * resize the rectified frame. A frame in NvMedia memory is streamed to CUDA
+   * first.
+   */
+  class CameraRectifier
+  {
+
+  public:
+    ~CameraRectifier();
+
+    /**
+     * @brief Initialization of the rectifier
+     *
+     * @param context Driveworks SDK handle
+     * @param rigPath rig file holding the model of the camera
+     * @param config camera options holding the rig sensor name and the field of view
+     * @param frameProperties properties of the full size RGBA frames to rectify
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool initialize(dwContextHandle_t context, const std::string &rigPath, const CameraConfig &config,
+                    const dwImageProperties &frameProperties);
+
+    /**
+     * @brief Release of the rectifier
+     */
+    void release();
+
+    /**
+     * @brief Rectification of one frame into getImage()
+     *
+     * @param frame full size RGBA frame with the properties given at initialization
+     * @param timeoutUs time to wait for the frame to be streamed to CUDA
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool rectify(dwImageHandle_t frame, dwTime_t timeoutUs);
+
+    /** @return rectified CUDA RGBA frame, valid until the next rectify() */
+    dwImageHandle_t getImage() const
+    {
+      return m_rectified;
+    }
+
+    /** @return intrinsics of the rectified frame */
+    const PinholeIntrinsics &getIntrinsics() const
+    {
+      return m_intrinsics;
+    }
+
+    /** @return true if the rectifier is initialized */
+    bool isEnabled() const
+    {
+      return m_rectifier != DW_NULL_HANDLE;
+    }
+
+  private:
+    bool createModels(dwContextHandle_t context, const std::string &rigPath, const CameraConfig &config,
+                      uint32_t width, uint32_t height);
+
+    dwCameraModelHandle_t m_cameraModel = DW_NULL_HANDLE;
+    dwCameraModelHandle_t m_pinholeModel = DW_NULL_HANDLE;
+    dwRectifierHandle_t m_rectifier = DW_NULL_HANDLE;
+    // NvMedia frames reach the remap kernel through a streamer
+    dwImageStreamerHandle_t m_streamer = DW_NULL_HANDLE;
+    dwImageHandle_t m_rectified = DW_NULL_HANDLE;
+    PinholeIntrinsics m_intrinsics;
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_CAMERA_RECTIFIER_H_
@@ -0,0 +1,123 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_CAPTURE_HEALTH_H_
+#define _NV_SENSORS_CAPTURE_HEALTH_H_
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @file capture_health.h
+ *
+ * @brief Declaration of the health state of a camera read loop.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @class CaptureHealth
+   * @brief Timeouts and backoff of the sensor reads of one camera
+   * @details Timeouts follow the frame period of the sensor instead of a
+   * fixed 30 fps budget. A missed read moves the camera from healthy to
+   * degraded, reads missing for STALL_TIME_US make it stalled, in which state
+   * reads are retried with an exponential backoff up to MAX_BACKOFF_US so a
+   * disconnected sensor neither spins a core nor floods the log. Every state
+   * change is logged once, a frame returns the camera to healthy. The state
+   * is written by the capture thread and may be read from any thread.
+   */
+  class CaptureHealth
+  {
+
+  public:
+    /** State of the read loop. */
+    enum State
+    {
+      HEALTHY = 0,
+      DEGRADED = 1,
+      STALLED = 2,
+    };
+
+    /** Time without a frame until a camera counts as stalled. */
+    static const int64_t STALL_TIME_US = 1000000;
+
+    /** Longest wait between two reads of a stalled camera. */
+    static const int64_t MAX_BACKOFF_US = 1000000;
+
+    /**
+     * @brief Initialization of the health state
+     *
+     * @param index camera index used in the log
+     * @param framePeriodUs frame period of the sensor in microseconds
+     */
+    void initialize(uint32_t index, int64_t framePeriodUs);
+
+    /** @return timeout of one sensor read in microseconds, two frame periods */
+    int64_t getReadTimeout() const
+    {
+      return 2 * m_framePeriodUs;
+    }
+
+    /** @return frame period of the sensor in microseconds */
+    int64_t getFramePeriod() const
+    {
+      return m_framePeriodUs;
+    }
+
+    /**
+     * @brief Report of a successful read
+     */
+    void onFrame();
+
+    /**
+     * @brief Report of a read without frame
+     *
+     * @param reason status name of the failed read
+     * @param waited true if the read waited for its timeout, false if it returned at once
+     *
+     * @return time in microseconds to wait before the next read
+     */
+    int64_t onMissed(const char *reason, bool waited);
+
+    /** @return current state */
+    State getState() const
+    {
+      return m_state.load(std::memory_order_relaxed);
+    }
+
+    /** @return name of the current state */
+    const char *getStateName() const;
+
+    /** @return reads without frame since the camera was started */
+    uint64_t getMissed() const
+    {
+      return m_missed.load(std::memory_order_relaxed);
+    }
+
+  private:
+    uint32_t m_index = 0;
+    int64_t m_framePeriodUs = 33333;
+
+    std::atomic<State> m_state{HEALTHY};
+    std::atomic<uint64_t> m_missed{0};
+    // owned by the capture thread
+    uint64_t m_consecutive = 0;
+    int64_t m_missedTime = 0;
+    int64_t m_backoff = 0;
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_CAPTURE_HEALTH_H_
@@ -0,0 +1,151 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_CONVERSION_SAMPLING_CUH_
+#define _NV_SENSORS_CONVERSION_SAMPLING_CUH_
+
+#include "group_tensor_kernels.h"
+
+/**
+ * @file conversion_sampling.cuh
+ *
+ * @brief Device functions reading one resized RGB pixel out of a YUV or RGBA
+ * frame, shared by the nvcc compiled conversion kernels.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  // interleaved sample of channel channel out of stride channels at a pixel
+  __device__ __forceinline__ float fetch(const uint8_t *plane, uint32_t pitch, int x, int y, int stride, int channel)
+  {
+    return static_cast<float>(plane[y * pitch + x * stride + channel]);
+  }
+
+  // mean of the 2x2 pixels from (x, y), the caller keeps them inside the plane
+  __device__ __forceinline__ float average(const uint8_t *plane, uint32_t pitch, int x, int y, int stride, int channel)
+  {
+    return 0.25f * (fetch(plane, pitch, x, y, stride, channel) + fetch(plane, pitch, x + 1, y, stride, channel) +
+                    fetch(plane, pitch, x, y + 1, stride, channel) + fetch(plane, pitch, x + 1, y + 1, stride, channel));
+  }
+
+  // bilinear sample of a plane of width x height pixels at the pixel center coordinates (fx, fy)
+  __device__ __forceinline__ float sample(const uint8_t *plane, uint32_t pitch, int width, int height, float fx,
+                                          float fy, int stride, int channel)
+  {
+    fx = fminf(fmaxf(fx, 0.0f), static_cast<float>(width - 1));
+    fy = fminf(fmaxf(fy, 0.0f), static_cast<float>(height - 1));
+
+    const int x0 = static_cast<int>(fx);
+    const int y0 = static_cast<int>(fy);
+    const int x1 = min(x0 + 1, width - 1);
+    const int y1 = min(y0 + 1, height - 1);
+    const float ax = fx - x0;
+    const float ay = fy - y0;
+
+    const float top = fetch(plane, pitch, x0, y0, stride, channel) * (1.0f - ax) + fetch(plane, pitch, x1, y0, stride, channel) * ax;
+    const float bottom = fetch(plane, pitch, x0, y1, stride, channel) * (1.0f - ax) + fetch(plane, pitch, x1, y1, stride, channel) * ax;
+    return top * (1.0f - ay) + bottom * ay;
+  }
+
+  // BT.601 limited range, not clamped
+  __device__ __forceinline__ void yuvToRgb(float luma, float u, float v, float &r, float &g, float &b)
+  {
+    const float c = 1.164f * (luma - 16.0f);
+    u -= 128.0f;
+    v -= 128.0f;
+    r = c + 1.596f * v;
+    g = c - 0.392f * u - 0.813f * v;
+    b = c + 2.017f * u;
+  }
+
+  /**
+   * @brief RGB of the pixel (x, y) of a frame resized to width x height
+   * @details Scale 0 samples bilinearly at any size. Scale 2 and 4 require a
+   * frame of exactly Scale times the output size: the bilinear taps then fall
+   * on pixel centers, so the pixel is the mean of 2x2 fixed pixels without
+   * clamping or weights, and the chroma of 1/2 is a single site. The result
+   * equals the one of scale 0. The values are not clamped.
+   */
+  template <TensorSourceFormat Format, int Scale>
+  __device__ __forceinline__ void sampleRgb(const uint8_t *const *plane, const uint32_t *pitch, int sourceWidth,
+                                            int sourceHeight, uint32_t width, uint32_t height, uint32_t x, uint32_t y,
+                                            float &r, float &g, float &b)
+  {
+    if (Scale == 0)
+    {
+      const float fx = (x + 0.5f) * sourceWidth / width - 0.5f;
+      const float fy = (y + 0.5f) * sourceHeight / height - 0.5f;
+      if (Format == TENSOR_SOURCE_RGBA)
+      {
+        r = sample(plane[0], pitch[0], sourceWidth, sourceHeight, fx, fy, 4, 0);
+        g = sample(plane[0], pitch[0], sourceWidth, sourceHeight, fx, fy, 4, 1);
+        b = sample(plane[0], pitch[0], sourceWidth, sourceHeight, fx, fy, 4, 2);
+        return;
+      }
+
+      // chroma sites at half resolution
+      const int chromaWidth = (sourceWidth + 1) / 2;
+      const int chromaHeight = (sourceHeight + 1) / 2;
+      const float cx = (fx + 0.5f) * 0.5f - 0.5f;
+      const float cy = (fy + 0.5f) * 0.5f - 0.5f;
+
+      const float luma = sample(plane[0], pitch[0], sourceWidth, sourceHeight, fx, fy, 1, 0);
+      float u, v;
+      if (Format == TENSOR_SOURCE_NV12)
+      {
+        u = sample(plane[1], pitch[1], chromaWidth, chromaHeight, cx, cy, 2, 0);
+        v = sample(plane[1], pitch[1], chromaWidth, chromaHeight, cx, cy, 2, 1);
+      }
+      else
+      {
+        u = sample(plane[1], pitch[1], chromaWidth, chromaHeight, cx, cy, 1, 0);
+        v = sample(plane[2], pitch[2], chromaWidth, chromaHeight, cx, cy, 1, 0);
+      }
+      yuvToRgb(luma, u, v, r, g, b);
+      return;
+    }
+
+    // top left of the 2x2 luma or RGBA pixels around the center of the output pixel
+    const int sx = Scale * x + Scale / 2 - 1;
+    const int sy = Scale * y + Scale / 2 - 1;
+    if (Format == TENSOR_SOURCE_RGBA)
+    {
+      r = average(plane[0], pitch[0], sx, sy, 4, 0);
+      g = average(plane[0], pitch[0], sx, sy, 4, 1);
+      b = average(plane[0], pitch[0], sx, sy, 4, 2);
+      return;
+    }
+
+    // the chroma site of the output pixel at 1/2, the 2x2 sites around it at 1/4
+    const int cx = Scale / 2 * x;
+    const int cy = Scale / 2 * y;
+    const float luma = average(plane[0], pitch[0], sx, sy, 1, 0);
+    float u, v;
+    if (Format == TENSOR_SOURCE_NV12)
+    {
+      u = Scale == 2 ? fetch(plane[1], pitch[1], cx, cy, 2, 0) : average(plane[1], pitch[1], cx, cy, 2, 0);
+      v = Scale == 2 ? fetch(plane[1], pitch[1], cx, cy, 2, 1) : average(plane[1], pitch[1], cx, cy, 2, 1);
+    }
+    else
+    {
+      u = Scale == 2 ? fetch(plane[1], pitch[1], cx, cy, 1, 0) : average(plane[1], pitch[1], cx, cy, 1, 0);
+      v = Scale == 2 ? fetch(plane[2], pitch[2], cx, cy, 1, 0) : average(plane[2], pitch[2], cx, cy, 1, 0);
+    }
+    yuvToRgb(luma, u, v, r, g, b);
+  }
+
+} // namespace nv
+
+#endif // _NV_SENSORS_CONVERSION_SAMPLING_CUH_
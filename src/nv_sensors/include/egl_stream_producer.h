@@ -0,0 +1,145 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_EGL_STREAM_PRODUCER_H_
+#define _NV_SENSORS_EGL_STREAM_PRODUCER_H_
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cuda.h>
+#include <cudaEGL.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @file egl_stream_producer.h
+ *
+ * @brief Declaration of a CUDA producer of a cross-process EGLStream.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @class EglStreamProducer
+   * @brief Shares pitch-linear RGBA CUDA buffers with a consumer process
+   * @details The producer listens on a UNIX domain socket. When a consumer
+   * connects, a mailbox mode EGLStream is created and its file descriptor is
+   * passed to the consumer, which connects as EGLStream CUDA consumer.
+   * Presented buffers are not copied, they stay owned by the producer and are
+   * handed back through reclaim() once the consumer released them or a newer
+   * frame replaced them in the mailbox. One consumer is served at a time.
+   */
+  class EglStreamProducer
+  {
+
+  public:
+    ~EglStreamProducer();
+
+    /**
+     * @brief Initialization of the producer
+     * @details Opens the EGL display and starts listening for a consumer.
+     *
+     * @param socketPath path of the UNIX domain socket
+     * @param width frame width in pixels
+     * @param height frame height in pixels
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool initialize(const std::string &socketPath, uint32_t width, uint32_t height);
+
+    /**
+     * @brief Release of the producer
+     * @details Disconnects the consumer and closes the socket, buffers still
+     * held by the stream may be reused by the caller afterwards.
+     */
+    void release();
+
+    /**
+     * @brief Query of consumer connection
+     *
+     * @return true if a consumer is connected to the stream
+     *         false otherwise
+     */
+    bool isConnected();
+
+    /**
+     * @brief Presentation of a frame
+     *
+     * @param dptr CUDA device pointer of the RGBA frame
+     * @param pitch row pitch of the frame in bytes
+     *
+     * @return true if the frame was handed to the stream and must not be
+     *         reused before reclaim() returns it
+     *         false if no consumer is connected
+     */
+    bool present(void *dptr, size_t pitch);
+
+    /**
+     * @brief Reclaim of a frame released by the consumer
+     * @details Does not wait. A frame replaced in the mailbox is returned
+     * right after present(), one held by the consumer once it released it.
+     *
+     * @return device pointer of a previously presented frame,
+     *         nullptr if none is released
+     */
+    void *reclaim();
+
+    /** @return true between initialize() and release() */
+    bool isInitialized() const
+    {
+      return m_listenSocket >= 0;
+    }
+
+    /** @return path of the UNIX domain socket consumers connect to */
+    const std::string &getSocketPath() const
+    {
+      return m_socketPath;
+    }
+
+  private:
+    bool loadExtensions();
+    bool connectConsumer(int client);
+    void disconnectConsumer();
+    void run_accept();
+
+    std::string m_socketPath;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+
+    EGLDisplay m_display = EGL_NO_DISPLAY;
+    EGLStreamKHR m_stream = EGL_NO_STREAM_KHR;
+    CUeglStreamConnection m_connection = nullptr;
+    bool m_connected = false;
+    std::mutex m_mutex;
+
+    int m_listenSocket = -1;
+    std::atomic<bool> m_run{false};
+    std::thread m_acceptThread;
+
+    PFNEGLQUERYDEVICESEXTPROC m_eglQueryDevicesEXT = nullptr;
+    PFNEGLGETPLATFORMDISPLAYEXTPROC m_eglGetPlatformDisplayEXT = nullptr;
+    PFNEGLCREATESTREAMKHRPROC m_eglCreateStreamKHR = nullptr;
+    PFNEGLDESTROYSTREAMKHRPROC m_eglDestroyStreamKHR = nullptr;
+    PFNEGLQUERYSTREAMKHRPROC m_eglQueryStreamKHR = nullptr;
+    PFNEGLGETSTREAMFILEDESCRIPTORKHRPROC m_eglGetStreamFileDescriptorKHR = nullptr;
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_EGL_STREAM_PRODUCER_H_
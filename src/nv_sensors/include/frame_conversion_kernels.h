@@ -0,0 +1,81 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_FRAME_CONVERSION_KERNELS_H_
+#define _NV_SENSORS_FRAME_CONVERSION_KERNELS_H_
+
+#include <cuda_runtime.h>
+
+#include "group_tensor_kernels.h"
+
+#include <cstdint>
+
+/**
+ * @file frame_conversion_kernels.h
+ *
+ * @brief Declaration of the CUDA kernels converting and resizing a native
+ * camera frame into an output in one pass. As group_tensor_kernels.h the
+ * header is shared with nvcc and does not depend on Driveworks or ROS.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @struct FrameConversion
+   * @brief Pitch-linear CUDA source frame and the interleaved 8 bit RGB(A) frame it is written to
+   */
+  struct FrameConversion
+  {
+    const uint8_t *plane[3];
+    uint32_t pitch[3];
+    TensorSourceFormat format;
+    uint32_t sourceWidth;
+    uint32_t sourceHeight;
+
+    uint8_t *output;
+    uint32_t outputPitch;
+    /** 4 for RGBA with an opaque alpha, 3 for RGB. */
+    uint32_t channels;
+    uint32_t width;
+    uint32_t height;
+  };
+
+  /**
+   * @brief Scale of a specialized conversion
+   * @details The kernels are compiled for YUV420 and NV12 sources resized to
+   * exactly 1/2 or 1/4 of their size, where the resize is a fixed average of
+   * 2x2 pixels. Other resizes are done by the generic bilinear path.
+   *
+   * @return 2 or 4 if the frame is exactly that multiple of the output size, 0 otherwise
+   */
+  int getConversionScale(uint32_t sourceWidth, uint32_t sourceHeight, uint32_t width, uint32_t height);
+
+  /**
+   * @brief Launch of the fused conversion
+   * @details Converts the frame to RGB (BT.601 limited range), resizes it and
+   * writes it to the output in a single kernel launch on stream, in place of
+   * dwImage_copyConvert() to full size followed by dwImageTransformation_copy().
+   *
+   * @param conversion source and output frame
+   * @param stream CUDA stream of the launch
+   *
+   * @return cudaSuccess if the kernel was queued
+   *         cudaErrorInvalidValue if no kernel is specialized for the formats and scale
+   */
+  cudaError_t launchFrameConversion(const FrameConversion &conversion, cudaStream_t stream);
+
+} // namespace nv
+
+#endif // _NV_SENSORS_FRAME_CONVERSION_KERNELS_H_
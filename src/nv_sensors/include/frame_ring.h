@@ -0,0 +1,281 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_FRAME_RING_H_
+#define _NV_SENSORS_FRAME_RING_H_
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+/**
+ * @file frame_ring.h
+ *
+ * @brief Declaration of a bounded single-producer/single-consumer ring
+ * connecting the stages of a capture pipeline.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @class FrameRing
+   * @brief A bounded lock-free SPSC ring with a drop-oldest push
+   * @details The ring carries small handles (frame handles, message pointers)
+   * between exactly one producer thread and one consumer thread. push() never
+   * blocks the producer: when the ring is full the oldest queued element is
+   * evicted and handed back to the producer, which owns its release. Both
+   * sides only touch the head index through compare-and-swap, so an element
+   * is consumed or evicted exactly once. The consumer may sleep in waitPop(),
+   * the producer only takes the mutex to wake a sleeping consumer. A producer
+   * which must not evict checks isFull() or waits in waitSpace() first.
+   *
+   * @tparam T trivially copyable handle type of at most 8 bytes, larger
+   * payloads are kept in a preallocated array and queued by index
+   */
+  template <typename T>
+  class FrameRing
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "FrameRing elements must be trivially copyable handles");
+    // wider elements make std::atomic<T> fall back to the locks of libatomic
+    static_assert(sizeof(T) <= sizeof(uint64_t), "FrameRing elements must fit a lock-free atomic");
+#if __cplusplus >= 201703L
+    static_assert(std::atomic<T>::is_always_lock_free, "FrameRing elements must be lock-free atomics");
+#endif
+
+  public:
+    /**
+     * @brief Allocation of the ring
+     * @details Must be called before the producer and consumer threads start.
+     *
+     * @param capacity maximum number of queued elements
+     */
+    void initialize(uint32_t capacity)
+    {
+      m_capacity = capacity > 0 ? capacity : 1;
+      m_slots.reset(new std::atomic<T>[m_capacity]);
+      assert(m_slots[0].is_lock_free());
+      m_head = 0;
+      m_tail = 0;
+      m_pushed = 0;
+      m_popped = 0;
+      m_dropped = 0;
+    }
+
+    /**
+     * @brief Producer side enqueue
+     *
+     * @param value element to enqueue
+     * @param evicted receives the evicted oldest element if the ring was full
+     *
+     * @return true if an element was evicted and must be released by the caller
+     *         false otherwise
+     */
+    bool push(T value, T &evicted)
+    {
+      bool dropped = false;
+      uint64_t tail = m_tail.load(std::memory_order_relaxed);
+      uint64_t head = m_head.load(std::memory_order_acquire);
+
+      while (tail - head >= m_capacity)
+      {
+        // full, take over the oldest element unless the consumer just did
+        if (m_head.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel))
+        {
+          evicted = m_slots[head % m_capacity].load(std::memory_order_relaxed);
+          dropped = true;
+          m_dropped.fetch_add(1, std::memory_order_relaxed);
+          break;
+        }
+      }
+
+      m_slots[tail % m_capacity].store(value, std::memory_order_relaxed);
+      m_tail.store(tail + 1, std::memory_order_seq_cst);
+      m_pushed.fetch_add(1, std::memory_order_relaxed);
+
+      if (m_waiting.load(std::memory_order_seq_cst))
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wakeup.notify_one();
+      }
+
+      return dropped;
+    }
+
+    /**
+     * @brief Consumer side non-blocking dequeue
+     *
+     * @param value receives the oldest element
+     *
+     * @return true if an element was dequeued
+     *         false if the ring is empty
+     */
+    bool pop(T &value)
+    {
+      uint64_t head = m_head.load(std::memory_order_acquire);
+      while (head != m_tail.load(std::memory_order_seq_cst))
+      {
+        T candidate = m_slots[head % m_capacity].load(std::memory_order_relaxed);
+        // fails if the producer evicted this element meanwhile, head is reloaded then
+        if (m_head.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel))
+        {
+          value = candidate;
+          m_popped.fetch_add(1, std::memory_order_relaxed);
+
+          // a producer waiting in waitSpace() sees the slot freed
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          if (m_producerWaiting.load(std::memory_order_seq_cst))
+          {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_space.notify_one();
+          }
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    /**
+     * @brief Consumer side blocking dequeue
+     *
+     * @param value receives the oldest element
+     * @param timeoutUs maximum time to wait in microseconds
+     *
+     * @return true if an element was dequeued
+     *         false if the ring stayed empty or wake() was called
+     */
+    bool waitPop(T &value, int64_t timeoutUs)
+    {
+      if (pop(value))
+      {
+        return true;
+      }
+
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_waiting.store(true, std::memory_order_seq_cst);
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(timeoutUs);
+      bool success = pop(value);
+      while (!success && !m_woken)
+      {
+        if (m_wakeup.wait_until(lock, deadline) == std::cv_status::timeout)
+        {
+          success = pop(value);
+          break;
+        }
+        success = pop(value);
+      }
+      m_waiting.store(false, std::memory_order_seq_cst);
+      m_woken = false;
+
+      return success;
+    }
+
+    /**
+     * @brief Producer side query of a full ring
+     * @details Only the consumer frees slots, so a ring which is not full
+     * stays so until the producer pushes.
+     *
+     * @return true if push() would evict the oldest element
+     */
+    bool isFull() const
+    {
+      return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_acquire) >= m_capacity;
+    }
+
+    /**
+     * @brief Producer side wait for a free slot
+     *
+     * @param timeoutUs maximum time to wait in microseconds
+     *
+     * @return true if the next push() does not evict
+     *         false if the ring stayed full or wake() was called
+     */
+    bool waitSpace(int64_t timeoutUs)
+    {
+      if (!isFull())
+      {
+        return true;
+      }
+
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_producerWaiting.store(true, std::memory_order_seq_cst);
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(timeoutUs);
+      bool space = !isFull();
+      while (!space && !m_producerWoken)
+      {
+        if (m_space.wait_until(lock, deadline) == std::cv_status::timeout)
+        {
+          space = !isFull();
+          break;
+        }
+        space = !isFull();
+      }
+      m_producerWaiting.store(false, std::memory_order_seq_cst);
+      m_producerWoken = false;
+
+      return space;
+    }
+
+    /**
+     * @brief Wake up of a consumer sleeping in waitPop() and a producer waiting in waitSpace()
+     * @details Used on shutdown so both can re-check their run flag.
+     */
+    void wake()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_woken = true;
+      m_producerWoken = true;
+      m_wakeup.notify_all();
+      m_space.notify_all();
+    }
+
+    /** @return number of elements enqueued since initialize() */
+    uint64_t getPushed() const { return m_pushed.load(std::memory_order_relaxed); }
+
+    /** @return number of elements dequeued since initialize() */
+    uint64_t getPopped() const { return m_popped.load(std::memory_order_relaxed); }
+
+    /** @return number of elements evicted by push() since initialize() */
+    uint64_t getDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+  private:
+    std::unique_ptr<std::atomic<T>[]> m_slots;
+    uint32_t m_capacity = 0;
+
+    // monotonically increasing indices, the slot is index % capacity
+    std::atomic<uint64_t> m_head{0};
+    std::atomic<uint64_t> m_tail{0};
+
+    std::atomic<uint64_t> m_pushed{0};
+    std::atomic<uint64_t> m_popped{0};
+    std::atomic<uint64_t> m_dropped{0};
+
+    std::atomic<bool> m_waiting{false};
+    bool m_woken = false;
+    std::atomic<bool> m_producerWaiting{false};
+    bool m_producerWoken = false;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::condition_variable m_space;
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_FRAME_RING_H_
@@ -0,0 +1,161 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_FRAME_STAMP_QUEUE_H_
+#define _NV_SENSORS_FRAME_STAMP_QUEUE_H_
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @file frame_stamp_queue.h
+ *
+ * @brief Declaration of the queue matching the packets of a serializer with
+ * the frames queued to it.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @class FrameStampQueue
+   * @brief A fixed-size lock-free SPSC FIFO of frame timestamps and sequence numbers
+   * @details A Driveworks serializer emits its packets on its own thread in
+   * the order the frames were queued, without telling which frame a packet
+   * belongs to. The thread queueing the frames pushes the stamp of every
+   * frame before handing it over, the serializer thread pops one stamp per
+   * packet starting a frame (see classifyVideoPacket()) and peeks at the
+   * next one for a packet preceding a frame. A frame the serializer refused
+   * is cancel()ed, its stamp is skipped by peek() and pop(). Unlike
+   * FrameRing nothing is evicted: while as many frames as the queue holds
+   * wait for their packets, push() fails and the frame must not be queued.
+   */
+  class FrameStampQueue
+  {
+
+  public:
+    /** Frames which may wait for their packet at once. */
+    static const uint32_t CAPACITY = 32;
+
+    /**
+     * @brief Removal of every stamp
+     * @details Must not be called while frames are queued or packets emitted.
+     */
+    void reset()
+    {
+      m_pushed.store(0, std::memory_order_relaxed);
+      m_popped.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Producer side enqueue of the stamp of the next frame
+     *
+     * @param timestamp sensor timestamp of the frame in us
+     * @param seq sequence number of the frame
+     *
+     * @return true if the stamp was queued
+     *         false if the queue is full
+     */
+    bool push(int64_t timestamp, uint32_t seq)
+    {
+      const uint64_t pushed = m_pushed.load(std::memory_order_relaxed);
+      if (pushed - m_popped.load(std::memory_order_acquire) >= CAPACITY)
+      {
+        return false;
+      }
+
+      Entry &entry = m_entries[pushed % CAPACITY];
+      entry.timestamp = timestamp;
+      entry.seq = seq;
+      entry.cancelled.store(false, std::memory_order_relaxed);
+      m_pushed.store(pushed + 1, std::memory_order_release);
+
+      return true;
+    }
+
+    /**
+     * @brief Producer side withdrawal of the stamp pushed last
+     * @details For a frame the serializer did not take after its stamp was
+     * pushed, no packet will match it.
+     */
+    void cancel()
+    {
+      m_entries[(m_pushed.load(std::memory_order_relaxed) - 1) % CAPACITY].cancelled.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Consumer side dequeue of the stamp of the next packet
+     *
+     * @param timestamp receives the sensor timestamp of the frame in us
+     * @param seq receives the sequence number of the frame
+     *
+     * @return true if a stamp was dequeued
+     *         false if no frame is waiting for a packet
+     */
+    bool pop(int64_t &timestamp, uint32_t &seq)
+    {
+      if (!peek(timestamp, seq))
+      {
+        return false;
+      }
+
+      m_popped.store(m_popped.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * @brief Consumer side read of the stamp of the next packet, which stays queued
+     *
+     * @param timestamp receives the sensor timestamp of the frame in us
+     * @param seq receives the sequence number of the frame
+     *
+     * @return true if a frame is waiting for a packet
+     *         false otherwise
+     */
+    bool peek(int64_t &timestamp, uint32_t &seq)
+    {
+      uint64_t popped = m_popped.load(std::memory_order_relaxed);
+      while (popped != m_pushed.load(std::memory_order_acquire))
+      {
+        const Entry &entry = m_entries[popped % CAPACITY];
+        if (!entry.cancelled.load(std::memory_order_acquire))
+        {
+          timestamp = entry.timestamp;
+          seq = entry.seq;
+          return true;
+        }
+
+        // no packet follows a cancelled frame
+        m_popped.store(++popped, std::memory_order_release);
+      }
+
+      return false;
+    }
+
+  private:
+    struct Entry
+    {
+      int64_t timestamp = 0;
+      uint32_t seq = 0;
+      std::atomic<bool> cancelled{false};
+    };
+
+    Entry m_entries[CAPACITY];
+    std::atomic<uint64_t> m_pushed{0};
+    std::atomic<uint64_t> m_popped{0};
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_FRAME_STAMP_QUEUE_H_
@@ -0,0 +1,137 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_GROUP_TENSOR_H_
+#define _NV_SENSORS_GROUP_TENSOR_H_
+
+#include <dw/core/Context.h>
+#include <dw/image/Image.h>
+#include <dw/interop/streamer/ImageStreamer.h>
+
+#include <ros/ros.h>
+
+#include "camera_config.h"
+#include "group_tensor_kernels.h"
+#include "time_mapper.h"
+#include "nv_sensors/Tensor.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @file group_tensor.h
+ *
+ * @brief Declaration of the batched tensor output of a camera group.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @class GroupTensor
+   * @brief Converts all frames of a capture into one RGB tensor and publishes it
+   * @details The native frames of all cameras of a group are converted to
+   * RGB, resized and packed into one contiguous NCHW or NHWC device buffer by
+   * a single kernel launch, then copied into a pooled nv_sensors/Tensor with
+   * one transfer on the same CUDA stream, so a capture costs one stream
+   * synchronization instead of a conversion and a transformation per camera.
+   * Frames which do not live in CUDA memory are mapped through one image
+   * streamer per camera. The tensor is published on <topic>/tensor.
+   */
+  class GroupTensor
+  {
+
+  public:
+    ~GroupTensor();
+
+    /**
+     * @brief Initialization of the tensor output
+     * @details Allocates the device tensor and the pooled messages, creates the
+     * CUDA stream and advertises the tensor topic.
+     *
+     * @param config output options holding layout, data type and size
+     * @param batch number of cameras converted per capture
+     * @param imageProperties native processed image properties of the cameras
+     * @param context Driveworks SDK handle
+     * @param depth number of pooled messages which may be in flight at once
+     * @param nh ros::NodeHandle used for advertising
+     * @param topic topic the tensor is published below
+     * @param frameId frame id of the message header
+     * @param clock maps the sensor timestamps to message stamps, must outlive the tensor output
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool initialize(const CameraConfig &config, uint32_t batch, const dwImageProperties &imageProperties,
+                    dwContextHandle_t context, uint32_t depth, ros::NodeHandle &nh, const std::string &topic,
+                    const std::string &frameId, const TimeMapper &clock);
+
+    /**
+     * @brief Release of the tensor output
+     * @details Must be called before the camera frames are released.
+     */
+    void release();
+
+    /**
+     * @brief Conversion and publishing of one capture
+     * @details Blocks until the tensor has been copied into a pooled message.
+     * A capture is skipped without error if there is no subscriber or every
+     * pooled message is still in flight.
+     *
+     * @param images native processed images of all cameras, ordered by sibling index
+     * @param timestamp sensor timestamp of the capture in us
+     * @param seq frame number of the capture
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool convert(const dwImageHandle_t *images, dwTime_t timestamp, uint32_t seq);
+
+    /** @return true if the tensor output is initialized */
+    bool isEnabled() const
+    {
+      return m_batch > 0;
+    }
+
+    /** @return number of captures skipped because every pooled message was in flight */
+    uint64_t getDropped() const
+    {
+      return m_dropped;
+    }
+
+  private:
+    nv_sensors::TensorPtr acquire();
+    void unmap(uint32_t count);
+
+    uint32_t m_batch = 0;
+    TensorBatch m_kernelBatch{};
+    size_t m_size = 0;
+
+    dwImageStreamerHandle_t m_streamer[MAX_TENSOR_BATCH] = {DW_NULL_HANDLE};
+    dwImageHandle_t m_mapped[MAX_TENSOR_BATCH] = {DW_NULL_HANDLE};
+    cudaStream_t m_stream = nullptr;
+    void *m_tensor = nullptr;
+
+    // data buffers are page-locked once, so the device to host copy runs asynchronously
+    std::vector<nv_sensors::TensorPtr> m_messages;
+    uint32_t m_next = 0;
+    uint64_t m_dropped = 0;
+
+    ros::Publisher m_publisher;
+    const TimeMapper *m_clock = nullptr;
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_GROUP_TENSOR_H_
@@ -0,0 +1,104 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_GROUP_TENSOR_KERNELS_H_
+#define _NV_SENSORS_GROUP_TENSOR_KERNELS_H_
+
+#include <cuda_runtime.h>
+
+#include "camera_config.h"
+
+#include <cstdint>
+
+/**
+ * @file group_tensor_kernels.h
+ *
+ * @brief Declaration of the CUDA kernel converting a batch of camera frames
+ * into one RGB tensor. The header is shared with the nvcc compiled kernels
+ * and therefore does not depend on Driveworks or ROS.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /** Maximum number of frames converted by one kernel launch. */
+  static const uint32_t MAX_TENSOR_BATCH = 16;
+
+  /**
+   *  @brief Declares the pixel format of the frames read by the kernel.
+   */
+  typedef enum _TensorSourceFormat {
+
+    /** Y, U and V planes, chroma at half resolution. */
+    TENSOR_SOURCE_YUV420 = 0,
+
+    /** Y plane followed by an interleaved UV plane at half resolution. */
+    TENSOR_SOURCE_NV12 = 1,
+
+    /** Interleaved RGBA, one plane. */
+    TENSOR_SOURCE_RGBA = 2,
+
+  } TensorSourceFormat;
+
+  /**
+   * @struct TensorBatch
+   * @brief Pitch-linear CUDA frames of one batch and the tensor they are written to
+   * @details Passed by value as kernel parameter, so a launch does not need
+   * a host to device upload of the frame pointers. All frames share one
+   * format and size.
+   */
+  struct TensorBatch
+  {
+    const uint8_t *plane[MAX_TENSOR_BATCH][3];
+    uint32_t pitch[MAX_TENSOR_BATCH][3];
+    uint32_t count;
+
+    TensorSourceFormat format;
+    uint32_t sourceWidth;
+    uint32_t sourceHeight;
+
+    /** Device buffer of count * 3 * height * width elements. */
+    void *tensor;
+    uint32_t width;
+    uint32_t height;
+    /** NCHW if true, NHWC otherwise. */
+    bool planar;
+    TensorDataType dataType;
+    /** Float elements hold value * scale + offset per tensor channel, value in [0, 255]. */
+    float scale[3];
+    float offset[3];
+    /** Channels written as B, G, R instead of R, G, B. */
+    bool bgr;
+  };
+
+  /**
+   * @brief Launch of the batched conversion
+   * @details Converts every frame of the batch to RGB (BT.601 limited range
+   * for YUV sources), resizes it bilinearly to the tensor size, normalizes it
+   * and writes it to its slice of the tensor, all in a single kernel launch
+   * on stream. Tensors of 1/2 or 1/4 of the frame size use a kernel
+   * specialized for the scale, which reads fixed pixels instead of
+   * interpolating and gives the same result.
+   *
+   * @param batch frames and tensor
+   * @param stream CUDA stream of the launch
+   * @param specialized false samples bilinearly at any scale, for comparison
+   *
+   * @return cudaSuccess if the kernel was queued
+   */
+  cudaError_t launchTensorConversion(const TensorBatch &batch, cudaStream_t stream, bool specialized = true);
+
+} // namespace nv
+
+#endif // _NV_SENSORS_GROUP_TENSOR_KERNELS_H_
@@ -0,0 +1,69 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_IMAGE_POOL_H_
+#define _NV_SENSORS_IMAGE_POOL_H_
+
+#include <sensor_msgs/Image.h>
+
+#include "message_pool.h"
+
+#include <string>
+
+/**
+ * @file image_pool.h
+ *
+ * @brief Declaration of a recycled pool of pre-sized sensor_msgs::Image.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @class ImagePool
+   * @brief A fixed set of pre-allocated sensor_msgs::Image messages
+   * @details A MessagePool of images, all messages and their data buffers
+   * are allocated once in initialize(). A message is handed out by acquire()
+   * and becomes free again as soon as every other owner (roscpp publisher
+   * queues, intra-process subscribers) has dropped its reference, so the
+   * capture loop does not allocate in steady state. acquire() must only be
+   * called from one thread. A message handed to another thread as a raw
+   * pointer stays reserved until that thread calls recycle().
+   */
+  class ImagePool : public MessagePool<sensor_msgs::Image>
+  {
+
+  public:
+    /**
+     * @brief Allocation of the pool
+     * @details Allocates depth messages with a data buffer of size bytes and
+     * presets the fields which do not change per frame. size is height * step
+     * for packed encodings and larger for planar ones, whose chroma planes
+     * follow the luma plane.
+     *
+     * @param depth number of messages which may be in flight at once
+     * @param encoding sensor_msgs::image_encodings of the messages
+     * @param width image width in pixels
+     * @param height image height in pixels
+     * @param step row length in bytes
+     * @param size data length in bytes
+     * @param frameId frame id of the message header
+     */
+    void initialize(uint32_t depth, const std::string &encoding, uint32_t width, uint32_t height,
+                    uint32_t step, size_t size, const std::string &frameId);
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_IMAGE_POOL_H_
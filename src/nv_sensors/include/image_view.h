@@ -0,0 +1,122 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_IMAGE_VIEW_H_
+#define _NV_SENSORS_IMAGE_VIEW_H_
+
+#include <sensor_msgs/Image.h>
+#include <ros/serialization.h>
+
+#include <cstring>
+
+/**
+ * @file image_view.h
+ *
+ * @brief Declaration of a non-owning image message which is serialized
+ * on the wire exactly like sensor_msgs/Image.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @struct ImageView
+   * @brief A sensor_msgs/Image whose payload is borrowed from an external buffer
+   * @details ImageView carries the same fields as sensor_msgs/Image but only
+   * points at the pixel data, so a frame can be published straight from the
+   * streamer CPU buffer without first being copied into a std::vector.
+   * roscpp serializes the view synchronously inside ros::Publisher::publish(),
+   * therefore the buffer only has to stay valid until publish() returns.
+   */
+  struct ImageView
+  {
+    std_msgs::Header header;
+    uint32_t height = 0;
+    uint32_t width = 0;
+    std::string encoding;
+    uint8_t is_bigendian = 0;
+    uint32_t step = 0;
+
+    /** Borrowed pixel data, height * step bytes. */
+    const uint8_t *data = nullptr;
+  };
+
+} // namespace nv
+
+namespace ros
+{
+  namespace message_traits
+  {
+    template <>
+    struct MD5Sum<nv::ImageView>
+    {
+      static const char *value() { return MD5Sum<sensor_msgs::Image>::value(); }
+      static const char *value(const nv::ImageView &) { return value(); }
+    };
+
+    template <>
+    struct DataType<nv::ImageView>
+    {
+      static const char *value() { return DataType<sensor_msgs::Image>::value(); }
+      static const char *value(const nv::ImageView &) { return value(); }
+    };
+
+    template <>
+    struct Definition<nv::ImageView>
+    {
+      static const char *value() { return Definition<sensor_msgs::Image>::value(); }
+      static const char *value(const nv::ImageView &) { return value(); }
+    };
+
+    template <>
+    struct HasHeader<nv::ImageView> : TrueType
+    {
+    };
+  } // namespace message_traits
+
+  namespace serialization
+  {
+    template <>
+    struct Serializer<nv::ImageView>
+    {
+      template <typename Stream>
+      inline static void write(Stream &stream, const nv::ImageView &m)
+      {
+        const uint32_t size = m.height * m.step;
+
+        stream.next(m.header);
+        stream.next(m.height);
+        stream.next(m.width);
+        stream.next(m.encoding);
+        stream.next(m.is_bigendian);
+        stream.next(m.step);
+        stream.next(size);
+        memcpy(stream.advance(size), m.data, size);
+      }
+
+      inline static uint32_t serializedLength(const nv::ImageView &m)
+      {
+        return serializationLength(m.header) +
+               serializationLength(m.height) +
+               serializationLength(m.width) +
+               serializationLength(m.encoding) +
+               serializationLength(m.is_bigendian) +
+               serializationLength(m.step) +
+               sizeof(uint32_t) + m.height * m.step;
+      }
+    };
+  } // namespace serialization
+} // namespace ros
+
+#endif // _NV_SENSORS_IMAGE_VIEW_H_
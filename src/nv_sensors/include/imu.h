@@ -0,0 +1,133 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_IMU_H_
+#define _NV_SENSORS_IMU_H_
+
+#include <dw/sensors/Sensors.h>
+#include <dw/sensors/imu/IMU.h>
+
+#include <sensor_msgs/Imu.h>
+
+#include "sensor_base.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+/**
+ * @file imu.h
+ *
+ * @brief Declaration of the IMU sensor of the producer.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @struct ImuCounters
+   * @brief Frame counters of the IMU
+   */
+  struct ImuCounters
+  {
+    /** Frames read from the sensor. */
+    std::atomic<uint64_t> frames{0};
+    /** Reads which timed out. */
+    std::atomic<uint64_t> missed{0};
+    /** Frames without acceleration or turn rate, not published. */
+    std::atomic<uint64_t> incomplete{0};
+    /** Messages handed to roscpp. */
+    std::atomic<uint64_t> published{0};
+  };
+
+  /**
+   * @struct ImuStats
+   * @brief Stage timings of the IMU
+   */
+  struct ImuStats
+  {
+    /** dwSensorIMU_readFrame() */
+    LatencyHistogram read;
+    /** ros::Publisher::publish() */
+    LatencyHistogram publish;
+    /** Timestamp of the frame until it was published. */
+    LatencyHistogram latency;
+  };
+
+  /**
+   * @class SensorIMU
+   * @brief A Driveworks IMU published as sensor_msgs/Imu
+   * @details One capture stage reads the frames with dwSensorIMU_readFrame()
+   * and publishes them on imuData right away; the messages are a few hundred
+   * bytes, so they need neither a pool nor a publish stage. Fields the
+   * sensor does not report are marked as unknown by a covariance of -1, as
+   * sensor_msgs/Imu defines.
+   */
+  class SensorIMU : public SensorBase
+  {
+
+  public:
+    ~SensorIMU();
+
+    /**
+     * @brief Start of the IMU
+     *
+     * @param params Driveworks IMU protocol and parameters, e.g. imu.virtual with file=...
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    virtual bool start(dwSensorParams params);
+
+    /**
+     * @brief Stop of the IMU
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    virtual bool stop();
+
+    /**
+     * @brief Release of the IMU, stops it if running
+     */
+    virtual void release();
+
+    /** @return true if the IMU is running */
+    virtual bool isSensorsRunning() const
+    {
+      return m_run;
+    }
+
+    virtual void collectStats(diagnostic_msgs::DiagnosticArray &diagnostics);
+
+  private:
+    void run_capture();
+    bool fillMessage(const dwIMUFrame &frame, sensor_msgs::Imu &message) const;
+
+    dwSensorHandle_t m_imu = DW_NULL_HANDLE;
+    std::atomic<bool> m_run{false};
+
+    ImuCounters m_counters;
+    ImuStats m_stats;
+    uint64_t m_statsFrames = 0;
+
+    std::thread m_captureThread;
+
+    ros::Publisher m_imuPub;
+    std::string m_frameId;
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_IMU_H_
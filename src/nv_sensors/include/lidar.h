@@ -0,0 +1,160 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_LIDAR_H_
+#define _NV_SENSORS_LIDAR_H_
+
+#include <dw/sensors/Sensors.h>
+#include <dw/sensors/lidar/Lidar.h>
+
+#include <sensor_msgs/PointCloud2.h>
+
+#include "frame_ring.h"
+#include "message_pool.h"
+#include "sensor_base.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+/**
+ * @file lidar.h
+ *
+ * @brief Declaration of the lidar sensor of the producer.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @struct LidarCounters
+   * @brief Packet and spin counters of the lidar
+   */
+  struct LidarCounters
+  {
+    /** Decoded packets read from the sensor. */
+    std::atomic<uint64_t> packets{0};
+    /** Reads which timed out. */
+    std::atomic<uint64_t> missed{0};
+    /** Completed spins. */
+    std::atomic<uint64_t> spins{0};
+    /** Spins dropped because every pooled message was in flight. */
+    std::atomic<uint64_t> noFreeMessage{0};
+    /** Points beyond the capacity of a pooled message. */
+    std::atomic<uint64_t> truncated{0};
+    /** Point clouds handed to roscpp. */
+    std::atomic<uint64_t> published{0};
+  };
+
+  /**
+   * @struct LidarStats
+   * @brief Stage timings of the lidar
+   */
+  struct LidarStats
+  {
+    /** dwSensorLidar_readPacket() */
+    LatencyHistogram read;
+    /** ros::Publisher::publish() */
+    LatencyHistogram publish;
+    /** Host timestamp of the first packet of a spin until it was published. */
+    LatencyHistogram latency;
+  };
+
+  /**
+   * @class SensorLidar
+   * @brief A Driveworks lidar published as sensor_msgs/PointCloud2
+   * @details The capture stage reads decoded packets with
+   * dwSensorLidar_readPacket() and appends their XYZI points to a pooled
+   * PointCloud2 sized for a full spin, whose data buffer is allocated once.
+   * A completed spin is queued to the publish stage, which publishes the
+   * cloud on lidarData with the host timestamp of its first packet. Without
+   * a free message the points of a spin are dropped as a whole.
+   */
+  class SensorLidar : public SensorBase
+  {
+
+  public:
+    ~SensorLidar();
+
+    /**
+     * @brief Start of the lidar
+     * @details Creates the sensor, sizes the message pool from the sensor
+     * properties, advertises lidarData and starts the capture and publish
+     * stages.
+     *
+     * @param params Driveworks lidar protocol and parameters, e.g. lidar.virtual with file=...
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    virtual bool start(dwSensorParams params);
+
+    /**
+     * @brief Stop of the lidar
+     * @details Joins the stages and releases the sensor and the message pool.
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    virtual bool stop();
+
+    /**
+     * @brief Release of the lidar, stops it if running
+     */
+    virtual void release();
+
+    /** @return true if the lidar is running */
+    virtual bool isSensorsRunning() const
+    {
+      return m_run;
+    }
+
+    virtual void collectStats(diagnostic_msgs::DiagnosticArray &diagnostics);
+
+  private:
+    void run_capture();
+    void run_publish();
+    void completeSpin();
+    void releaseSensor();
+
+    dwSensorHandle_t m_lidar = DW_NULL_HANDLE;
+    dwLidarProperties m_properties{};
+    std::atomic<bool> m_run{false};
+
+    // capacity of one message in points, a spin and one packet
+    uint32_t m_capacity = 0;
+    // spin being filled by the capture stage, nullptr while it is dropped
+    sensor_msgs::PointCloud2Ptr m_cloud;
+    uint32_t m_points = 0;
+    bool m_spinStarted = false;
+    dwTime_t m_spinStamp = 0;
+
+    // number of pooled messages which may be in flight (~pool_depth), connected by a ring of ~ring_depth
+    MessagePool<sensor_msgs::PointCloud2> m_pool;
+    FrameRing<sensor_msgs::PointCloud2 *> m_ring;
+
+    LidarCounters m_counters;
+    LidarStats m_stats;
+    uint64_t m_statsSpins = 0;
+
+    std::thread m_captureThread;
+    std::thread m_publishThread;
+
+    ros::Publisher m_cloudPub;
+    std::string m_frameId;
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_LIDAR_H_
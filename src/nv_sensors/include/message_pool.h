@@ -0,0 +1,161 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_MESSAGE_POOL_H_
+#define _NV_SENSORS_MESSAGE_POOL_H_
+
+#include <boost/shared_ptr.hpp>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @file message_pool.h
+ *
+ * @brief Declaration of a recycled pool of pre-allocated ROS messages.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @class MessagePool
+   * @brief A fixed set of pre-allocated messages of any type
+   * @details The messages are created once from a template holding the
+   * fields which do not change per message and the buffers sized for the
+   * largest one; ImagePool is the pool of the camera images.
+   * A message handed out by acquire() is free again once every other owner
+   * dropped its reference and, if it was passed to another thread as a raw
+   * pointer, that thread called recycle(). acquire() must only be called
+   * from one thread.
+   */
+  template <typename M>
+  class MessagePool
+  {
+
+  public:
+    typedef boost::shared_ptr<M> MessagePtr;
+
+    /**
+     * @brief Allocation of the pool
+     *
+     * @param depth number of messages which may be in flight at once
+     * @param prototype message every pooled message is copied from
+     */
+    void initialize(uint32_t depth, const M &prototype)
+    {
+      release();
+
+      m_messages.reserve(depth);
+      m_reserved.reset(new std::atomic<bool>[depth]);
+      for (uint32_t i = 0; i < depth; ++i)
+      {
+        m_messages.push_back(MessagePtr(new M(prototype)));
+        m_reserved[i] = false;
+      }
+    }
+
+    /**
+     * @brief Release of the pool
+     * @details Drops the pool references, messages still held by roscpp are
+     * freed when their last owner releases them.
+     */
+    void release()
+    {
+      m_messages.clear();
+      m_reserved.reset();
+      m_next = 0;
+    }
+
+    /**
+     * @brief Acquisition of a free message
+     *
+     * @return a message not referenced outside of the pool,
+     *         nullptr if all messages are still in flight
+     */
+    MessagePtr acquire()
+    {
+      for (size_t n = 0; n < m_messages.size(); ++n)
+      {
+        const uint32_t i = m_next;
+        m_next = (m_next + 1) % m_messages.size();
+
+        // the pool holds the only reference once roscpp is done with the message
+        if (!m_reserved[i].load(std::memory_order_acquire) && m_messages[i].use_count() == 1)
+        {
+          m_reserved[i].store(true, std::memory_order_relaxed);
+          return m_messages[i];
+        }
+      }
+
+      return MessagePtr();
+    }
+
+    /**
+     * @brief Lookup of a pooled message
+     *
+     * @param message raw pointer of an acquired message
+     *
+     * @return reference to the message, nullptr if it is not owned by the pool
+     */
+    MessagePtr share(const M *message) const
+    {
+      int32_t i = find(message);
+      return i < 0 ? MessagePtr() : m_messages[i];
+    }
+
+    /**
+     * @brief Return of a reserved message
+     * @details May be called from any thread.
+     *
+     * @param message raw pointer of an acquired message
+     */
+    void recycle(const M *message)
+    {
+      int32_t i = find(message);
+      if (i >= 0)
+      {
+        m_reserved[i].store(false, std::memory_order_release);
+      }
+    }
+
+    /** @return number of messages owned by the pool */
+    uint32_t getDepth() const
+    {
+      return static_cast<uint32_t>(m_messages.size());
+    }
+
+  private:
+    int32_t find(const M *message) const
+    {
+      for (size_t i = 0; i < m_messages.size(); ++i)
+      {
+        if (m_messages[i].get() == message)
+        {
+          return static_cast<int32_t>(i);
+        }
+      }
+
+      return -1;
+    }
+
+    std::vector<MessagePtr> m_messages;
+    std::unique_ptr<std::atomic<bool>[]> m_reserved;
+    uint32_t m_next = 0;
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_MESSAGE_POOL_H_
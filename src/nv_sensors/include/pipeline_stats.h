@@ -0,0 +1,160 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_PIPELINE_STATS_H_
+#define _NV_SENSORS_PIPELINE_STATS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @file pipeline_stats.h
+ *
+ * @brief Declaration of the latency histograms recorded on the hot path
+ * of the capture pipeline.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /** Clock of the stage timings. */
+  typedef std::chrono::steady_clock PipelineClock;
+
+  /**
+   * @class LatencyHistogram
+   * @brief A lock-free histogram of durations in microseconds
+   * @details Values below 16 us have their own bucket, larger values fall into
+   * four buckets per power of two, so a percentile is reported with less than
+   * 25% error. record() is one relaxed atomic increment plus a compare of the
+   * maximum and may be called from any thread. collect() summarizes and resets
+   * the histogram, so every collection covers the time since the previous one.
+   */
+  class LatencyHistogram
+  {
+
+  public:
+    /** Number of buckets, covers durations up to 2^32 us. */
+    static const uint32_t BUCKET_COUNT = 128;
+
+    /**
+     * @struct Summary
+     * @brief Durations recorded since the previous collection
+     */
+    struct Summary
+    {
+      uint64_t count = 0;
+      int64_t p50 = 0;
+      int64_t p99 = 0;
+      int64_t max = 0;
+    };
+
+    /**
+     * @brief Recording of a duration
+     *
+     * @param us duration in microseconds, negative durations count as 0
+     */
+    void record(int64_t us)
+    {
+      if (us < 0)
+      {
+        us = 0;
+      }
+
+      m_buckets[getBucket(static_cast<uint64_t>(us))].fetch_add(1, std::memory_order_relaxed);
+
+      int64_t max = m_max.load(std::memory_order_relaxed);
+      while (us > max && !m_max.compare_exchange_weak(max, us, std::memory_order_relaxed))
+      {
+      }
+    }
+
+    /**
+     * @brief Recording of the time elapsed since a stage started
+     *
+     * @param start PipelineClock time the stage started at
+     */
+    void record(const PipelineClock::time_point &start)
+    {
+      record(std::chrono::duration_cast<std::chrono::microseconds>(PipelineClock::now() - start).count());
+    }
+
+    /**
+     * @brief Summary and reset of the histogram
+     *
+     * @return count, percentiles and maximum recorded since the previous call
+     */
+    Summary collect();
+
+  private:
+    static uint32_t getBucket(uint64_t us)
+    {
+      if (us < 16)
+      {
+        return static_cast<uint32_t>(us);
+      }
+
+      uint32_t msb = 63 - static_cast<uint32_t>(__builtin_clzll(us));
+      uint32_t bucket = 16 + (msb - 4) * 4 + static_cast<uint32_t>((us >> (msb - 2)) & 3);
+      return bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT - 1;
+    }
+
+    // largest duration falling into a bucket
+    static int64_t getBucketLimit(uint32_t bucket);
+
+    std::atomic<uint64_t> m_buckets[BUCKET_COUNT] = {};
+    std::atomic<int64_t> m_max{0};
+  };
+
+  /**
+   * @struct CameraStats
+   * @brief Stage timings of the capture and convert stages of one camera
+   */
+  struct CameraStats
+  {
+    /** dwSensorCamera_readFrameNew() */
+    LatencyHistogram read;
+    /** Hand-over of the frame to the hardware encoder. */
+    LatencyHistogram encode;
+    /** dwImage_copyConvert() of the native frame. */
+    LatencyHistogram convert;
+    /** Lens undistortion of the converted frame, rectify=true. */
+    LatencyHistogram rectify;
+    /** Batched conversion of a capture into the tensor, including its transfer. */
+    LatencyHistogram tensor;
+  };
+
+  /**
+   * @struct OutputStats
+   * @brief Stage timings of one camera output
+   */
+  struct OutputStats
+  {
+    /** Crop and resize or copy into the streamer target. */
+    LatencyHistogram transform;
+    /** dwImageStreamer_producerSend() */
+    LatencyHistogram send;
+    /** Time from producerSend() until the receive stage got the frame. */
+    LatencyHistogram stream;
+    /** Copy of the streamed frame into a pooled message. */
+    LatencyHistogram copy;
+    /** ros::Publisher::publish() */
+    LatencyHistogram publish;
+    /** Sensor timestamp of the frame until it was published. */
+    LatencyHistogram latency;
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_PIPELINE_STATS_H_
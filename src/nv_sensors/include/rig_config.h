@@ -0,0 +1,55 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_RIG_CONFIG_H_
+#define _NV_SENSORS_RIG_CONFIG_H_
+
+#include <dw/core/Context.h>
+
+#include <string>
+
+/**
+ * @file rig_config.h
+ *
+ * @brief Declaration of the camera start request read from a Driveworks rig file.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /** Rig sensor property holding the output options of a camera. */
+  static const char RIG_OUTPUT_PROPERTY[] = "nv_sensors";
+
+  /**
+   * @brief Reading of the cameras of a rig file
+   * @details Builds a start request with one parameter set per camera of the
+   * rig, in rig order. A set holds the sensor parameters of the rig, the
+   * output options of the sensor property RIG_OUTPUT_PROPERTY (e.g.
+   * "output=full,output-encoding=rgb8") and frame-id=<sensor name>. Camera n
+   * of the rig publishes on cameraData_<n> as for a start request with
+   * several cameras. All cameras of the rig must share one protocol.
+   *
+   * @param context Driveworks SDK handle
+   * @param path path of the rig JSON file
+   * @param protocol receives the sensor protocol, e.g. camera.gmsl
+   * @param params receives the parameter sets separated by SensorCamera::CAMERA_PARAMS_SEPARATOR
+   *
+   * @return true if the rig holds at least one camera and was read
+   *         false otherwise
+   */
+  bool loadRigCameras(dwContextHandle_t context, const std::string &path, std::string &protocol, std::string &params);
+
+} // namespace nv
+
+#endif // _NV_SENSORS_RIG_CONFIG_H_
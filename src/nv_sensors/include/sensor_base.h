@@ -0,0 +1,191 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_SENSOR_BASE_H_
+#define _NV_SENSORS_SENSOR_BASE_H_
+
+#include <dw/core/Context.h>
+#include <dw/sensors/Sensors.h>
+
+#include <ros/ros.h>
+#include <diagnostic_msgs/DiagnosticArray.h>
+
+#include "pipeline_stats.h"
+#include "thread_policy.h"
+#include "time_mapper.h"
+
+#include <mutex>
+#include <string>
+
+/**
+ * @file sensor_base.h
+ *
+ * @brief Declaration of the facilities shared by all sensors of the producer.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @class SensorBase
+   * @brief A Driveworks sensor type served by the producer
+   * @details All sensors share the Driveworks context and SAL instance of
+   * the node, read their thread placement from the same ~capture_*,
+   * ~convert_* and ~publish_* options, map their stamps with ~time_domain
+   * and publish their statistics on /diagnostics every ~stats_period
+   * seconds. A sensor opens its devices in start(), runs one capture stage
+   * thread per device, connected to its publish stage by a FrameRing where
+   * the messages are large, and frees everything in stop().
+   */
+  class SensorBase
+  {
+
+  public:
+    virtual ~SensorBase() = default;
+
+    /**
+     * @brief Initialization of the sensor
+     * @details Provides the Driveworks handles shared by all sensors.
+     *
+     * @param context Driveworks SDK handle
+     * @param hal Driveworks SAL handle
+     */
+    void initialize(dwContextHandle_t context, dwSALHandle_t hal)
+    {
+      m_sdk = context;
+      m_hal = hal;
+    }
+
+    /**
+     * @brief Setting of NodeHandle
+     * @details Sets the ros::NodeHandle on which the topics are advertised
+     * and the private ros::NodeHandle from which the node options are read.
+     *
+     * @params nh ros::NodeHandle used for advertising
+     * @params pnh private ros::NodeHandle holding the node options
+     */
+    void setNodeHandle(const ros::NodeHandle &nh, const ros::NodeHandle &pnh)
+    {
+      m_nodeHandle = nh;
+      m_privateNodeHandle = pnh;
+    }
+
+    /**
+     * @brief Setting of the thread slot
+     * @details The threads of the sensor are pinned to the slot-th core of
+     * the set of their stage, so sensors sharing a set are spread over it.
+     *
+     * @param slot index into the core sets of the stages
+     */
+    void setThreadSlot(uint32_t slot)
+    {
+      m_threadSlot = slot;
+    }
+
+    /**
+     * @brief Start of data acquisition
+     *
+     * @param params Driveworks protocol and parameters of the sensor
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    virtual bool start(dwSensorParams params) = 0;
+
+    /**
+     * @brief Stop of data acquisition
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    virtual bool stop() = 0;
+
+    /**
+     * @brief Release of everything the sensor allocated
+     */
+    virtual void release() = 0;
+
+    /** @return true if data acquisition is active */
+    virtual bool isSensorsRunning() const = 0;
+
+    /**
+     * @brief Collection of the statistics
+     * @details Fills the statuses of the sensor with rates, drop counters and
+     * stage durations since the previous collection and resets the stage
+     * histograms.
+     *
+     * @param diagnostics receives the statistics
+     */
+    virtual void collectStats(diagnostic_msgs::DiagnosticArray &diagnostics) = 0;
+
+  protected:
+    /**
+     * @brief Reading of the options shared by all sensors
+     * @details Reads ~stats_period, ~time_sync_period and the thread
+     * policies and measures the clock offset of ~time_domain.
+     *
+     * @return true if all options are valid
+     *         false otherwise
+     */
+    bool loadCommonOptions();
+
+    /**
+     * @brief Start of the clock and statistics timers once the sensor runs
+     */
+    void startTimers();
+
+    /**
+     * @brief Stop of the clock and statistics timers
+     */
+    void stopTimers();
+
+    static void addValue(diagnostic_msgs::DiagnosticStatus &status, const std::string &key, const std::string &value);
+    // percentiles of one stage since the previous collection
+    static void addStage(diagnostic_msgs::DiagnosticStatus &status, const std::string &stage,
+                         LatencyHistogram &histogram);
+    static std::string formatRate(double rate);
+
+    dwContextHandle_t m_sdk = DW_NULL_HANDLE;
+    dwSALHandle_t m_hal = DW_NULL_HANDLE;
+    ros::NodeHandle m_nodeHandle;
+    ros::NodeHandle m_privateNodeHandle;
+
+    // placement of the stage threads (~capture_*, ~convert_*, ~publish_*), publish covers the receive stage
+    ThreadPolicy m_capturePolicy;
+    ThreadPolicy m_convertPolicy;
+    ThreadPolicy m_publishPolicy;
+    uint32_t m_threadSlot = 0;
+
+    // header stamps in the sensor or the ROS time domain (~time_domain), offset updated every ~time_sync_period seconds
+    TimeMapper m_clock;
+    double m_timeSyncPeriod = 1.0;
+
+    // stage timings published on /diagnostics every ~stats_period seconds
+    double m_statsPeriod = 1.0;
+    PipelineClock::time_point m_statsTime;
+    // the timer may fire on another spinner thread while the sensor changes
+    std::mutex m_statsMutex;
+
+  private:
+    void syncClock(const ros::WallTimerEvent &event);
+    void publishStats(const ros::WallTimerEvent &event);
+
+    ros::WallTimer m_clockTimer;
+    ros::WallTimer m_statsTimer;
+    ros::Publisher m_diagnosticsPub;
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_SENSOR_BASE_H_
@@ -0,0 +1,159 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_SENSORS_NODE_H_
+#define _NV_SENSORS_SENSORS_NODE_H_
+
+#include "camera.h"
+#include "imu.h"
+#include "lidar.h"
+#include "nv_sensors/CameraStatus.h"
+#include "nv_sensors/camera_reconfigure.h"
+#include "nv_sensors/camera_record_start.h"
+#include "nv_sensors/camera_record_stop.h"
+#include "nv_sensors/camera_start.h"
+#include "nv_sensors/camera_stop.h"
+
+#include <ros/ros.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @file sensors_node.h
+ *
+ * @brief Declaration of the producer node shared by the standalone
+ * executable and the nodelet.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @class SensorsNode
+   * @brief Driveworks context, sensors and services of the producer
+   * @details SensorsNode owns the Driveworks SDK and SAL handles and the
+   * sensors, and advertises the camera_start, camera_stop and
+   * camera_reconfigure services.
+   * It does not spin, so it can be hosted by nv_sensors_producer as well as
+   * by a nodelet manager, where subscribers in the same manager receive the
+   * published messages without serialization.
+   * A lidar (~lidar_protocol, ~lidar_params) and an IMU (~imu_protocol,
+   * ~imu_params) are started at launch on the same Driveworks context and
+   * run until the node is released.
+   *
+   * Starting, stopping, preparing and releasing cameras takes long, so with
+   * ~async_control (default) these requests are queued to a control thread
+   * and the service returns as soon as the request is accepted. The state of
+   * the cameras and the outcome of every request are published on the
+   * latched camera_status topic. The other services are handled on the
+   * calling thread and rejected while a control request runs, callbacks may
+   * be called from several spinner threads.
+   */
+  class SensorsNode
+  {
+
+  public:
+    ~SensorsNode();
+
+    /**
+     * @brief Initialization of the node
+     * @details Initializes the Driveworks SDK and SAL and advertises the
+     * sensor services.
+     *
+     * @param nh ros::NodeHandle for services and topics
+     * @param pnh private ros::NodeHandle holding the node options
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool initialize(const ros::NodeHandle &nh, const ros::NodeHandle &pnh);
+
+    /**
+     * @brief Release of the node
+     * @details Stops running sensors and releases the Driveworks handles.
+     */
+    void release();
+
+  private:
+    /**
+     * @struct ControlRequest
+     * @brief A start, stop, prepare or release request queued to the control thread
+     */
+    struct ControlRequest
+    {
+      enum Command
+      {
+        START,
+        STOP,
+        PREPARE,
+        RELEASE,
+      };
+      Command command;
+      std::string driver;
+      std::string params;
+    };
+
+    bool startSensor(SensorBase &sensor, const ros::NodeHandle &pnh, const std::string &name, uint32_t slot);
+    bool submit(const ControlRequest &request);
+    bool execute(const ControlRequest &request);
+    void run_control();
+    void publishStatus(const std::string &state, const std::string &command, bool success, const std::string &message);
+    void publishStatus(const std::string &command, bool success, const std::string &message);
+
+    bool onCameraStart(nv_sensors::camera_start::Request &req, nv_sensors::camera_start::Response &res);
+    bool onCameraStop(nv_sensors::camera_stop::Request &req, nv_sensors::camera_stop::Response &res);
+    bool onCameraPrepare(nv_sensors::camera_start::Request &req, nv_sensors::camera_start::Response &res);
+    bool onCameraRelease(nv_sensors::camera_stop::Request &req, nv_sensors::camera_stop::Response &res);
+    bool onCameraReconfigure(nv_sensors::camera_reconfigure::Request &req, nv_sensors::camera_reconfigure::Response &res);
+    bool onRecordStart(nv_sensors::camera_record_start::Request &req, nv_sensors::camera_record_start::Response &res);
+    bool onRecordStop(nv_sensors::camera_record_stop::Request &req, nv_sensors::camera_record_stop::Response &res);
+
+    dwContextHandle_t m_sdk = DW_NULL_HANDLE;
+    dwSALHandle_t m_hal = DW_NULL_HANDLE;
+
+    SensorCamera m_cameraSensor;
+    SensorLidar m_lidarSensor;
+    SensorIMU m_imuSensor;
+
+    // queue the long camera requests instead of blocking the service caller (~async_control)
+    bool m_asyncControl = true;
+    std::thread m_controlThread;
+    std::mutex m_controlMutex;
+    std::condition_variable m_controlCondition;
+    std::deque<ControlRequest> m_controlQueue;
+    bool m_controlRun = false;
+    // set while a control request runs, the short services are rejected meanwhile
+    std::atomic<bool> m_controlBusy{false};
+    // held by whoever changes the cameras
+    std::mutex m_sensorMutex;
+
+    ros::NodeHandle m_nodeHandle;
+    ros::Publisher m_statusPub;
+    ros::ServiceServer m_cameraStartService;
+    ros::ServiceServer m_cameraStopService;
+    ros::ServiceServer m_cameraPrepareService;
+    ros::ServiceServer m_cameraReleaseService;
+    ros::ServiceServer m_cameraReconfigureService;
+    ros::ServiceServer m_recordStartService;
+    ros::ServiceServer m_recordStopService;
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_SENSORS_NODE_H_
@@ -0,0 +1,91 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_SHM_IMAGE_TRANSPORT_H_
+#define _NV_SENSORS_SHM_IMAGE_TRANSPORT_H_
+
+#include <image_transport/simple_publisher_plugin.h>
+#include <image_transport/simple_subscriber_plugin.h>
+
+#include "nv_sensors/ShmImage.h"
+#include "shm_ring.h"
+
+#include <mutex>
+#include <string>
+
+/**
+ * @file shm_image_transport.h
+ *
+ * @brief Declaration of the image_transport "shm" plugins.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @class ShmPublisher
+   * @brief image_transport publisher of the "shm" transport
+   * @details Copies every image once into a slot of a shared-memory ring named
+   * after the topic and publishes a nv_sensors/ShmImage descriptor on
+   * <topic>/shm. The ring is created with the first image and recreated for a
+   * larger one. The nv_sensors producer writes its own ring straight from the
+   * streamer buffer and publishes the same descriptors.
+   */
+  class ShmPublisher : public image_transport::SimplePublisherPlugin<nv_sensors::ShmImage>
+  {
+
+  public:
+    virtual std::string getTransportName() const
+    {
+      return "shm";
+    }
+
+  protected:
+    virtual void publish(const sensor_msgs::Image &message, const PublishFn &publish_fn) const;
+
+  private:
+    mutable std::mutex m_mutex;
+    mutable ShmRing m_ring;
+  };
+
+  /**
+   * @class ShmSubscriber
+   * @brief image_transport subscriber of the "shm" transport
+   * @details Maps the ring named by a descriptor and copies the slot into the
+   * sensor_msgs/Image handed to the callback, holding a reference on the
+   * slot only for the copy. The copy is made once per subscriber, as
+   * image_transport hands every subscriber its own message. A descriptor
+   * whose slot was overwritten before it arrived is dropped. Consumers which
+   * can read the pixels in place subscribe to the descriptors and use
+   * ShmRing::open(), lock() and unlock() instead, see ShmRing.
+   */
+  class ShmSubscriber : public image_transport::SimpleSubscriberPlugin<nv_sensors::ShmImage>
+  {
+
+  public:
+    virtual std::string getTransportName() const
+    {
+      return "shm";
+    }
+
+  protected:
+    virtual void internalCallback(const nv_sensors::ShmImage::ConstPtr &message, const Callback &user_cb);
+
+  private:
+    ShmRing m_ring;
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_SHM_IMAGE_TRANSPORT_H_
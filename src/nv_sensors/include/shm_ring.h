@@ -0,0 +1,190 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_SHM_RING_H_
+#define _NV_SENSORS_SHM_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file shm_ring.h
+ *
+ * @brief Declaration of a ring of image slots in POSIX shared memory.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @class ShmRing
+   * @brief Fixed-size slots in a POSIX shared-memory object, shared by one writer and any number of readers
+   * @details The writer creates the object and fills one free slot per
+   * frame, readers map it by name and read a slot in place while they hold a
+   * reference on it. Every slot carries a reference count and a generation
+   * in the shared memory: the writer only takes a slot nobody references and
+   * bumps its generation when it does, a reader only keeps a reference if the
+   * generation still matches the one published with the frame. A
+   * subscriber therefore never waits for the writer and the writer never
+   * waits for a subscriber, it drops the frame if every slot is held.
+   *
+   * Readers which use the pixels in place open() the segment of a
+   * nv_sensors/ShmImage descriptor, lock() its slot and generation and
+   * unlock() the slot when done; ShmSubscriber instead copies the slot into
+   * a sensor_msgs/Image for every subscriber.
+   *
+   * The writer side is not thread safe, a reader may be used from any number
+   * of threads. A reader which crashes while holding a slot keeps it held
+   * until the writer recreates the object.
+   */
+  class ShmRing
+  {
+
+  public:
+    /** Slots of a ring if not configured otherwise. */
+    static const uint32_t DEFAULT_SLOT_COUNT = 4;
+
+    ~ShmRing();
+
+    /**
+     * @brief Creation of the shared-memory object by the writer
+     * @details An object of the same name, and the objects of the same topic
+     * left behind by writers which are no longer running (see
+     * getSegmentName()), are removed first. Readers which still map the
+     * previous ring of the writer keep reading their slots until they see the
+     * new name.
+     *
+     * @param name POSIX shared-memory object name, see getSegmentName()
+     * @param slotCount number of slots
+     * @param slotSize payload bytes of one slot
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool create(const std::string &name, uint32_t slotCount, size_t slotSize);
+
+    /**
+     * @brief Mapping of a shared-memory object created by a writer
+     *
+     * @param name POSIX shared-memory object name published with the frames
+     *
+     * @return true if execution successful
+     *         false otherwise
+     */
+    bool open(const std::string &name);
+
+    /**
+     * @brief Release of the mapping
+     * @details The writer also removes the object name, readers keep their
+     * mappings until they release them.
+     */
+    void release();
+
+    /**
+     * @brief Reservation of a free slot by the writer
+     * @details Frames published from the slot before are invalidated.
+     *
+     * @param slot index of the reserved slot
+     *
+     * @return payload of the slot, nullptr if every slot is held by a reader
+     */
+    uint8_t *acquire(uint32_t &slot);
+
+    /**
+     * @brief Hand-over of a written slot to the readers
+     *
+     * @param slot index returned by acquire()
+     * @param size bytes written, at most getSlotSize()
+     *
+     * @return generation to publish with the frame
+     */
+    uint32_t commit(uint32_t slot, size_t size);
+
+    /**
+     * @brief Reference on a published slot by a reader
+     *
+     * @param slot index published with the frame
+     * @param generation generation published with the frame
+     * @param size bytes written to the slot
+     *
+     * @return payload of the slot, nullptr if it was overwritten since; must be unlocked if not null
+     */
+    const uint8_t *lock(uint32_t slot, uint32_t generation, size_t &size);
+
+    /**
+     * @brief Release of a reference taken by lock()
+     */
+    void unlock(uint32_t slot);
+
+    /** @return true if the object is created or mapped */
+    bool isOpen() const
+    {
+      return m_mapping != nullptr;
+    }
+
+    /** @return name of the created or mapped object */
+    const std::string &getName() const
+    {
+      return m_name;
+    }
+
+    /** @return payload bytes of one slot */
+    size_t getSlotSize() const
+    {
+      return m_slotSize;
+    }
+
+    /** @return frames the writer dropped because every slot was held */
+    uint64_t getDropped() const
+    {
+      return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Object name of a new ring of a topic
+     * @details The name holds the writer process id and a count of the names
+     * given out by the process, so neither a restarted writer nor a ring
+     * recreated by the same writer shares a name with its predecessor.
+     * Readers map the ring again when the name published with a frame
+     * changes. Call once per create().
+     *
+     * @param topic topic the frames are published on
+     *
+     * @return POSIX shared-memory object name
+     */
+    static std::string getSegmentName(const std::string &topic);
+
+  private:
+    struct Header;
+    struct Slot;
+
+    Slot *getSlot(uint32_t slot) const;
+
+    std::string m_name;
+    uint8_t *m_mapping = nullptr;
+    size_t m_mappingSize = 0;
+    uint32_t m_slotCount = 0;
+    size_t m_slotSize = 0;
+    bool m_owner = false;
+
+    // owned by the writer
+    uint32_t m_next = 0;
+    std::atomic<uint64_t> m_dropped{0};
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_SHM_RING_H_
@@ -0,0 +1,89 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_THREAD_POLICY_H_
+#define _NV_SENSORS_THREAD_POLICY_H_
+
+#include <ros/ros.h>
+
+#include <sched.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file thread_policy.h
+ *
+ * @brief Declaration of the CPU placement and scheduling of pipeline threads.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @struct ThreadPolicy
+   * @brief CPU placement and scheduling of the threads of one pipeline stage
+   * @details Read from the private parameters ~<stage>_cpus (e.g. "2,3" or
+   * "2-5"), ~<stage>_sched (other, fifo or rr) and ~<stage>_priority. The
+   * threads of camera n are pinned to the n-th core of the set, wrapping
+   * around, so several cameras are spread over the set.
+   */
+  struct ThreadPolicy
+  {
+    /** Cores of the stage, empty keeps the inherited affinity. */
+    std::vector<int> cpus;
+
+    /** SCHED_OTHER, SCHED_FIFO or SCHED_RR. */
+    int policy = SCHED_OTHER;
+
+    /** Real-time priority of SCHED_FIFO and SCHED_RR. */
+    int priority = 0;
+  };
+
+  /**
+   * @brief Reading of the policy of a pipeline stage
+   *
+   * @param pnh private ros::NodeHandle holding the node options
+   * @param stage parameter prefix of the stage, e.g. "capture"
+   * @param policy receives the policy
+   *
+   * @return true if all parameters are valid
+   *         false otherwise
+   */
+  bool loadThreadPolicy(const ros::NodeHandle &pnh, const std::string &stage, ThreadPolicy &policy);
+
+  /**
+   * @brief Placement of a started thread
+   * @details Names the thread and applies affinity and scheduling. Failures,
+   * typically a missing CAP_SYS_NICE for real-time policies, are logged and
+   * leave the thread running with the inherited settings.
+   *
+   * @param thread started thread
+   * @param policy policy of the stage of the thread
+   * @param index camera index selecting the core out of the set
+   * @param name thread name, truncated to 15 characters
+   */
+  void applyThreadPolicy(std::thread &thread, const ThreadPolicy &policy, uint32_t index, const std::string &name);
+
+  /**
+   * @brief Locking of the process memory
+   * @details mlockall() of the current and future pages, so the pipeline does
+   * not stall on page faults. Failures are logged.
+   */
+  void lockMemory();
+
+} // namespace nv
+
+#endif // _NV_SENSORS_THREAD_POLICY_H_
@@ -0,0 +1,142 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_TIME_MAPPER_H_
+#define _NV_SENSORS_TIME_MAPPER_H_
+
+#include <dw/core/Context.h>
+#include <ros/ros.h>
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @file time_mapper.h
+ *
+ * @brief Declaration of the mapping of sensor timestamps to header stamps.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @class TimeMapper
+   * @brief Maps sensor timestamps in the Driveworks time base to header stamps
+   * @details Sensor timestamps are taken in the time base of the Driveworks
+   * context, the host TSC or the PTP time the context is synchronized to.
+   * With ~time_domain=sensor (default) they are published unchanged. With
+   * ~time_domain=ros they are shifted by the offset between the ROS clock
+   * and the Driveworks clock. update() estimates that offset from several
+   * back to back readings of both clocks, keeping the reading with the
+   * shortest ROS bracket, and smooths it; a step beyond MAX_STEP_US, e.g. a
+   * PTP or NTP correction, is taken over at once. Stamps may be mapped from
+   * any thread while update() runs.
+   */
+  class TimeMapper
+  {
+
+  public:
+    /** Time base of the published stamps. */
+    enum Domain
+    {
+      SENSOR = 0,
+      ROS = 1,
+    };
+
+    /** Offset change taken over without smoothing. */
+    static const int64_t MAX_STEP_US = 1000;
+
+    /**
+     * @brief Initialization of the mapping
+     * @details Reads ~time_domain and takes a first offset estimate.
+     *
+     * @param pnh private ros::NodeHandle holding the node options
+     * @param context Driveworks SDK handle
+     *
+     * @return true if the options are valid
+     *         false otherwise
+     */
+    bool initialize(const ros::NodeHandle &pnh, dwContextHandle_t context);
+
+    /**
+     * @brief Estimation of the offset between the ROS and the Driveworks clock
+     */
+    void update();
+
+    /**
+     * @brief Mapping of a sensor timestamp
+     *
+     * @param timestamp sensor timestamp in us
+     *
+     * @return header stamp in the configured domain
+     */
+    ros::Time toStamp(dwTime_t timestamp) const
+    {
+      const int64_t us = timestamp + getOffset();
+      ros::Time stamp;
+      stamp.sec = static_cast<uint32_t>(us / 1000000L);
+      stamp.nsec = static_cast<uint32_t>((us % 1000000L) * 1000);
+      return stamp;
+    }
+
+    /**
+     * @brief Inverse mapping of a header stamp
+     *
+     * @param stamp header stamp in the configured domain
+     *
+     * @return sensor timestamp in us
+     */
+    dwTime_t toSensorTime(const ros::Time &stamp) const
+    {
+      return static_cast<dwTime_t>(stamp.sec) * 1000000L + stamp.nsec / 1000 - getOffset();
+    }
+
+    /** @return configured domain */
+    Domain getDomain() const
+    {
+      return m_domain;
+    }
+
+    /** @return name of the configured domain */
+    const char *getDomainName() const
+    {
+      return m_domain == ROS ? "ros" : "sensor";
+    }
+
+    /** @return offset in us added to sensor timestamps, 0 in the sensor domain */
+    int64_t getOffset() const
+    {
+      return m_offset.load(std::memory_order_relaxed);
+    }
+
+    /** @return smoothed deviation in us of the offset readings from the estimate */
+    int64_t getJitter() const
+    {
+      return m_jitter.load(std::memory_order_relaxed);
+    }
+
+  private:
+    bool sample(int64_t &offset, int64_t &bracket);
+
+    dwContextHandle_t m_context = DW_NULL_HANDLE;
+    Domain m_domain = SENSOR;
+    bool m_estimated = false;
+
+    std::atomic<int64_t> m_offset{0};
+    std::atomic<int64_t> m_jitter{0};
+  };
+
+} // namespace nv
+
+#endif // _NV_SENSORS_TIME_MAPPER_H_
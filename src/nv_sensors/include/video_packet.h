@@ -0,0 +1,62 @@
+/*Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+
+  NVIDIA CORPORATION and its licensors retain all intellectual property
+  and proprietary rights in and to this software, related documentation
+  and any modifications thereto.  Any use, reproduction, disclosure or
+  distribution of this software and related documentation without an express
+  license agreement from NVIDIA CORPORATION is strictly prohibited.
+
+  SPDX-License-Identifier: MIT*/
+
+#ifndef _NV_SENSORS_VIDEO_PACKET_H_
+#define _NV_SENSORS_VIDEO_PACKET_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file video_packet.h
+ *
+ * @brief Declaration of the classification of the H.264/H.265 packets of a
+ * hardware encoder by the frames they start.
+ */
+
+/**
+ *  @namespace nv
+ *  @brief A global namespace for Nv packages
+ */
+namespace nv
+{
+
+  /**
+   * @enum VideoPacketContent
+   * @brief What an encoder packet holds relative to the frames queued to the encoder
+   */
+  enum VideoPacketContent
+  {
+    /** The first slice of a frame, the packet starts the next queued frame. */
+    VIDEO_PACKET_FRAME,
+    /** Only parameter sets, SEI or delimiters, which precede the next frame. */
+    VIDEO_PACKET_HEADER,
+    /** Further slices or bytes of the frame started by an earlier packet. */
+    VIDEO_PACKET_CONTINUATION,
+  };
+
+  /**
+   * @brief Classification of an Annex B encoder packet
+   * @details The packet starts a frame if it holds a slice NAL unit with
+   * first_mb_in_slice 0 (H.264) or first_slice_segment_in_pic_flag set
+   * (H.265). A packet which does not begin with a start code continues the
+   * NAL unit of the previous one.
+   *
+   * @param data packet bytes
+   * @param size packet length in bytes
+   * @param h265 true for an H.265 stream, false for H.264
+   *
+   * @return content of the packet
+   */
+  VideoPacketContent classifyVideoPacket(const uint8_t *data, size_t size, bool h265);
+
+} // namespace nv
+
+#endif // _NV_SENSORS_VIDEO_PACKET_H_
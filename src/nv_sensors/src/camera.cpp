@@ -10,289 +10,2664 @@
  */
 
 #include "camera.h"
+#include "camera_group_view.h"
+#include "image_view.h"
+#include "nvcommon.h"
+#include "nv_sensors/CudaFrame.h"
+#include "nv_sensors/ShmImage.h"
 #include "sensor_msgs/Image.h"
 #include "sensor_msgs/image_encodings.h"
-#include "sensor_msgs/fill_image.h"
+#include "diagnostic_msgs/DiagnosticArray.h"
+
+#include <dw/core/Context.h>
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
 
 using namespace sensor_msgs;
 
-// macro to easily check for dw errors
-#define CHECK_DW_ERROR(x)                                                                                                                                                                          \
-  {                                                                                                                                                                                                \
-    dwStatus result = x;                                                                                                                                                                           \
-    if (result != DW_SUCCESS)                                                                                                                                                                      \
-    {                                                                                                                                                                                              \
-      throw std::runtime_error(std::string("DW Error ") + dwGetStatusName(result) + std::string(" executing DW function:\n " #x) + std::string("\n at " __FILE__ ":") + std::to_string(__LINE__)); \
-    }                                                                                                                                                                                              \
-  };
+namespace nv
+{
+
+  // copy of a pitched image into a tightly packed buffer
+  static void copyImageRows(uint8_t *dst, size_t dstStep, const uint8_t *src, size_t srcPitch, size_t rowSize, uint32_t rows)
+  {
+    if (dstStep == srcPitch)
+    {
+      memcpy(dst, src, dstStep * rows);
+      return;
+    }
+
+    for (uint32_t row = 0; row < rows; ++row)
+    {
+      memcpy(dst + row * dstStep, src + row * srcPitch, rowSize);
+    }
+  }
+
+  // streamed Driveworks format of an encoding, bgr8 is streamed as rgb and swapped while copying
+  static dwImageFormat getImageFormat(OutputEncoding encoding)
+  {
+    switch (encoding)
+    {
+    case OUTPUT_ENCODING_RGB8:
+    case OUTPUT_ENCODING_BGR8:
+      return DW_IMAGE_FORMAT_RGB_UINT8;
+    case OUTPUT_ENCODING_MONO8:
+      return DW_IMAGE_FORMAT_R_UINT8;
+    case OUTPUT_ENCODING_YUV420:
+      return DW_IMAGE_FORMAT_YUV420_UINT8_PLANAR;
+    case OUTPUT_ENCODING_NV12:
+      return DW_IMAGE_FORMAT_YUV420_UINT8_SEMIPLANAR;
+    default:
+      return DW_IMAGE_FORMAT_RGBA_UINT8;
+    }
+  }
+
+  // source of the fused kernels, YUV frames only
+  static bool getFusedFormat(dwImageFormat format, TensorSourceFormat &source)
+  {
+    switch (format)
+    {
+    case DW_IMAGE_FORMAT_YUV420_UINT8_PLANAR:
+      source = TENSOR_SOURCE_YUV420;
+      return true;
+    case DW_IMAGE_FORMAT_YUV420_UINT8_SEMIPLANAR:
+      source = TENSOR_SOURCE_NV12;
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  static const char *getEncodingName(OutputEncoding encoding)
+  {
+    switch (encoding)
+    {
+    case OUTPUT_ENCODING_RGB8:
+      return sensor_msgs::image_encodings::RGB8.c_str();
+    case OUTPUT_ENCODING_BGR8:
+      return sensor_msgs::image_encodings::BGR8.c_str();
+    case OUTPUT_ENCODING_MONO8:
+      return sensor_msgs::image_encodings::MONO8.c_str();
+    case OUTPUT_ENCODING_YUV420:
+      return "yuv420";
+    case OUTPUT_ENCODING_NV12:
+      return "nv12";
+    default:
+      return sensor_msgs::image_encodings::RGBA8.c_str();
+    }
+  }
+
+  // bytes per pixel of the first plane
+  static uint32_t getPixelSize(OutputEncoding encoding)
+  {
+    switch (encoding)
+    {
+    case OUTPUT_ENCODING_RGB8:
+    case OUTPUT_ENCODING_BGR8:
+      return 3;
+    case OUTPUT_ENCODING_MONO8:
+    case OUTPUT_ENCODING_YUV420:
+    case OUTPUT_ENCODING_NV12:
+      return 1;
+    default:
+      return 4;
+    }
+  }
+
+  // payload of a published frame, the 4:2:0 chroma samples follow the luma plane
+  static size_t getFrameSize(OutputEncoding encoding, uint32_t width, uint32_t height)
+  {
+    size_t size = static_cast<size_t>(width) * getPixelSize(encoding) * height;
+    if (encoding == OUTPUT_ENCODING_YUV420 || encoding == OUTPUT_ENCODING_NV12)
+    {
+      size += 2 * static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+    }
+    return size;
+  }
+
+  // frames which are one plane in the published layout can be borrowed from the streamer buffer
+  static bool isViewable(OutputEncoding encoding)
+  {
+    return encoding == OUTPUT_ENCODING_RGBA8 || encoding == OUTPUT_ENCODING_RGB8 || encoding == OUTPUT_ENCODING_MONO8;
+  }
+
+  // copy of a streamed frame into a packed message payload
+  static void copyFrame(uint8_t *dst, const dwImageCPU *src, OutputEncoding encoding, uint32_t width, uint32_t height)
+  {
+    const size_t step = static_cast<size_t>(width) * getPixelSize(encoding);
+
+    if (encoding == OUTPUT_ENCODING_BGR8)
+    {
+      for (uint32_t row = 0; row < height; ++row)
+      {
+        const uint8_t *in = src->data[0] + row * src->pitch[0];
+        uint8_t *out = dst + row * step;
+        for (uint32_t x = 0; x < width; ++x, in += 3, out += 3)
+        {
+          out[0] = in[2];
+          out[1] = in[1];
+          out[2] = in[0];
+        }
+      }
+      return;
+    }
+
+    copyImageRows(dst, step, src->data[0], src->pitch[0], step, height);
+    dst += step * height;
+
+    const uint32_t chromaWidth = (width + 1) / 2;
+    const uint32_t chromaHeight = (height + 1) / 2;
+    if (encoding == OUTPUT_ENCODING_YUV420)
+    {
+      // U plane then V plane
+      for (uint32_t plane = 1; plane < 3; ++plane)
+      {
+        copyImageRows(dst, chromaWidth, src->data[plane], src->pitch[plane], chromaWidth, chromaHeight);
+        dst += static_cast<size_t>(chromaWidth) * chromaHeight;
+      }
+    }
+    else if (encoding == OUTPUT_ENCODING_NV12)
+    {
+      // interleaved UV plane
+      copyImageRows(dst, 2 * chromaWidth, src->data[1], src->pitch[1], 2 * chromaWidth, chromaHeight);
+    }
+  }
+
+  // current PipelineClock time in us
+  static int64_t getPipelineTime()
+  {
+    return std::chrono::duration_cast<std::chrono::microseconds>(PipelineClock::now().time_since_epoch()).count();
+  }
+
+  bool SensorCamera::prepare(dwSensorParams params)
+  {
+    if (m_cameraRun)
+    {
+      ROS_WARN("CAMERA sensor running, stop it before preparing");
+      return false;
+    }
+
+    if (m_prepared)
+    {
+      releasePrepared();
+    }
+    if (!prepareCameras(params))
+    {
+      return false;
+    }
+
+    m_keepPrepared = true;
+    ROS_INFO("%u camera(s) prepared, camera_start and camera_stop only start and stop the sensors", m_cameraCount);
+
+    return true;
+  }
+
+  bool SensorCamera::start(dwSensorParams params)
+  {
+    // a request matching the prepared cameras only starts the sensors
+    if (m_prepared && !isPreparedFor(params))
+    {
+      ROS_INFO("start request differs from the prepared cameras, preparing again");
+      releasePrepared();
+    }
+    if (!m_prepared)
+    {
+      m_keepPrepared = false;
+      if (!prepareCameras(params))
+      {
+        return false;
+      }
+    }
+
+    return runCameras();
+  }
+
+  void SensorCamera::release()
+  {
+    m_keepPrepared = false;
+    if (m_cameraRun)
+    {
+      stop();
+    }
+    else if (m_prepared)
+    {
+      releasePrepared();
+    }
+  }
+
+  bool SensorCamera::isPreparedFor(const dwSensorParams &params) const
+  {
+    return m_preparedProtocol == (params.protocol ? params.protocol : "") &&
+           m_preparedParams == (params.parameters ? params.parameters : "");
+  }
+
+  bool SensorCamera::prepareCameras(dwSensorParams paramsClient)
+  {
+    // split the request into one parameter set per camera
+    std::vector<std::string> cameraParams;
+    {
+      std::string params = paramsClient.parameters ? paramsClient.parameters : "";
+      size_t begin = 0;
+      while (begin <= params.size())
+      {
+        size_t end = params.find(CAMERA_PARAMS_SEPARATOR, begin);
+        if (end == std::string::npos)
+        {
+          end = params.size();
+        }
+        if (end > begin)
+        {
+          cameraParams.push_back(params.substr(begin, end - begin));
+        }
+        begin = end + 1;
+      }
+    }
+
+    if (cameraParams.empty())
+    {
+      cameraParams.push_back("");
+    }
+
+    if (cameraParams.size() > MAX_CAMERAS)
+    {
+      ROS_ERROR("Cannot start %zu cameras, at most %u are supported", cameraParams.size(), MAX_CAMERAS);
+      return false;
+    }
+
+    m_privateNodeHandle.param("lazy", m_lazy, true);
+    m_privateNodeHandle.param("parallel_start", m_parallelStart, true);
+    m_privateNodeHandle.param("zero_copy", m_zeroCopy, false);
+    m_privateNodeHandle.param("fused_convert", m_fusedConvert, true);
+    m_privateNodeHandle.param("rig", m_rigPath, std::string());
+    m_privateNodeHandle.param("pool_depth", m_poolDepth, 4);
+    if (m_poolDepth < 1)
+    {
+      ROS_WARN("Invalid pool_depth %d, using 1", m_poolDepth);
+      m_poolDepth = 1;
+    }
+    m_privateNodeHandle.param("shm_slots", m_shmSlots, static_cast<int>(ShmRing::DEFAULT_SLOT_COUNT));
+    if (m_shmSlots < 0)
+    {
+      ROS_WARN("Invalid shm_slots %d, using 0", m_shmSlots);
+      m_shmSlots = 0;
+    }
+    m_privateNodeHandle.param("ring_depth", m_ringDepth, 2);
+    if (m_ringDepth < 1)
+    {
+      ROS_WARN("Invalid ring_depth %d, using 1", m_ringDepth);
+      m_ringDepth = 1;
+    }
+    if (!m_zeroCopy && m_poolDepth <= m_ringDepth)
+    {
+      ROS_WARN("pool_depth %d does not exceed ring_depth %d, frames will be dropped for lack of messages", m_poolDepth, m_ringDepth);
+    }
+    m_privateNodeHandle.param("streamer_depth", m_streamerDepth, 2);
+    if (m_streamerDepth < 1 || m_streamerDepth > static_cast<int>(MAX_STREAMER_DEPTH))
+    {
+      ROS_WARN("Invalid streamer_depth %d, using %u", m_streamerDepth, MAX_STREAMER_DEPTH);
+      m_streamerDepth = MAX_STREAMER_DEPTH;
+    }
+    m_privateNodeHandle.param("capture_rate", m_captureRate, 0.0);
+    if (!loadCommonOptions())
+    {
+      return false;
+    }
+
+    // the pages of all pools are touched by then, later allocations are locked as well
+    bool lock = false;
+    m_privateNodeHandle.param("lock_memory", lock, false);
+    if (lock && !m_memoryLocked)
+    {
+      lockMemory();
+      m_memoryLocked = true;
+    }
+
+    // output options are removed from the parameters handed to Driveworks
+    std::vector<CameraConfig> configs(cameraParams.size());
+    std::vector<std::string> sensorParams(cameraParams.size());
+    for (uint32_t i = 0; i < cameraParams.size(); ++i)
+    {
+      if (!parseCameraConfig(cameraParams[i], configs[i], sensorParams[i]))
+      {
+        ROS_ERROR("Invalid output options for camera %u: %s", i, cameraParams[i].c_str());
+        return false;
+      }
+      if (m_zeroCopy && configs[i].outputDomain == OUTPUT_DOMAIN_CPU && !isViewable(configs[i].outputEncoding))
+      {
+        ROS_WARN("camera %u output-encoding needs a copy, zero_copy is not used", i);
+      }
+    }
+
+    // a sensor with siblings occupies one camera slot per sibling
+    m_cameraCount = 0;
+    m_groupCount = 0;
+    for (uint32_t i = 0; i < cameraParams.size(); ++i)
+    {
+      dwSensorParams params = paramsClient;
+      params.parameters = sensorParams[i].c_str();
+
+      if (!createCamera(m_cameraCount, params, configs[i]))
+      {
+        releasePrepared();
+        return false;
+      }
+      m_cameraCount += m_groupSize[m_cameraCount];
+    }
+
+    // keep the legacy names for a single camera
+    for (uint32_t i = 0; i < m_cameraCount; ++i)
+    {
+      m_topic[i] = "cameraData";
+      m_frameId[i] = "camera";
+      m_socketPath[i] = SocketPathOutput;
+      if (m_cameraCount > 1)
+      {
+        m_topic[i] += "_" + std::to_string(i);
+        m_frameId[i] += "_" + std::to_string(i);
+        m_socketPath[i] += "_" + std::to_string(i);
+      }
+      if (!m_config[i].frameId.empty())
+      {
+        m_frameId[i] = m_config[i].frameId;
+        if (m_groupSize[i] > 1)
+        {
+          m_frameId[i] += "_" + std::to_string(m_sibling[i]);
+        }
+      }
+    }
+
+    // images, streamers, transformations and serializers share the SAL and the context, they are created one after another
+    for (uint32_t i = 0; i < m_cameraCount; ++i)
+    {
+      if (!startCamera(i))
+      {
+        releasePrepared();
+        return false;
+      }
+    }
+
+    // the pooled images of all siblings are also published as one message per group capture
+    uint32_t group = 0;
+    for (uint32_t i = 0; i < m_cameraCount; i += m_groupSize[i])
+    {
+      if (m_groupSize[i] < 2)
+      {
+        continue;
+      }
+
+      GroupBatch &batch = m_groupBatch[i];
+      batch.topic = "cameraGroup";
+      if (m_groupCount > 1)
+      {
+        batch.topic += "_" + std::to_string(group);
+      }
+      group++;
+
+      if (m_config[i].rawOutput && m_config[i].outputDomain == OUTPUT_DOMAIN_CPU)
+      {
+        batch.publisher = m_nodeHandle.advertise<CameraGroupView>(batch.topic, 1);
+        ROS_INFO("cameras %u to %u being published together on topic /%s", i, i + m_groupSize[i] - 1, batch.topic.c_str());
+      }
+    }
+
+    // the tensor of a group is published below the group topic, of a single camera below the camera topic
+    for (uint32_t i = 0; i < m_cameraCount; i += m_groupSize[i])
+    {
+      if (m_config[i].tensorLayout == TENSOR_LAYOUT_NONE)
+      {
+        continue;
+      }
+
+      dwImageProperties imageProperties{};
+      dwStatus status = dwSensorCamera_getImageProperties(&imageProperties, DW_CAMERA_OUTPUT_NATIVE_PROCESSED, m_camera[i]);
+      if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("Cannot get image properties of camera %u. Error: %s", i, dwGetStatusName(status));
+        releasePrepared();
+        return false;
+      }
+
+      const bool group = m_groupSize[i] > 1;
+      const std::string &topic = group ? m_groupBatch[i].topic : m_topic[i];
+      if (!m_tensor[i].initialize(m_config[i], m_groupSize[i], imageProperties, m_sdk, m_poolDepth, m_nodeHandle,
+                                  topic, group ? topic : m_frameId[i], m_clock))
+      {
+        releasePrepared();
+        return false;
+      }
+
+      if (group)
+      {
+        m_groupPassCount[i] = m_ringDepth + 2;
+        m_groupPass[i].reset(new GroupPass[m_groupPassCount[i]]);
+        m_groupRing[i].initialize(m_ringDepth);
+      }
+    }
+
+    // advertise one topic per camera output, subscribers may connect before the sensors start
+    for (uint32_t i = 0; i < m_cameraCount; ++i)
+    {
+      advertiseOutputs(i);
+    }
+
+    m_preparedProtocol = paramsClient.protocol ? paramsClient.protocol : "";
+    m_preparedParams = paramsClient.parameters ? paramsClient.parameters : "";
+    m_prepared = true;
+
+    return true;
+  }
+
+  bool SensorCamera::runCameras()
+  {
+    // the offset to ROS time is measured before the first frame
+    m_clock.update();
+
+    for (uint32_t i = 0; i < m_cameraCount; ++i)
+    {
+      if (!armCamera(i))
+      {
+        abortRun();
+        return false;
+      }
+    }
+
+    // siblings start with their master, only the wait for the sensors runs on one thread per master
+    const bool started = forEachCamera(true, [this](uint32_t i) {
+      dwStatus status = dwSensor_start(m_camera[i]);
+      if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("Cannot start camera %u. Error: %s", i, dwGetStatusName(status));
+        return false;
+      }
+      return true;
+    });
+    if (!started)
+    {
+      abortRun();
+      return false;
+    }
+
+    m_cameraRun = true;
+    for (uint32_t i = 0; i < m_cameraCount; ++i)
+    {
+      m_pipelineRun[i] = true;
+      startPipelineThreads(i);
+      // the master reads the frames of all siblings
+      if (m_cameraMaster[i] == i)
+      {
+        m_cameraThread[i] = std::thread(&SensorCamera::run_capture, this, i);
+        applyThreadPolicy(m_cameraThread[i], m_capturePolicy, i, "nv_capture_" + std::to_string(i));
+      }
+    }
+
+    startTimers();
+
+    return true;
+  }
+
+  bool SensorCamera::forEachCamera(bool masters, const std::function<bool(uint32_t)> &step)
+  {
+    bool success[MAX_CAMERAS];
+    std::thread threads[MAX_CAMERAS];
+    for (uint32_t i = 0; i < m_cameraCount; i += masters ? m_groupSize[i] : 1)
+    {
+      success[i] = true;
+      if (m_parallelStart)
+      {
+        threads[i] = std::thread([&step, &success, i] { success[i] = step(i); });
+      }
+      else if (!step(i))
+      {
+        return false;
+      }
+    }
+
+    // every step runs to its end, a failed one is cleaned up with the others by the caller
+    bool all = true;
+    for (uint32_t i = 0; i < m_cameraCount; i += masters ? m_groupSize[i] : 1)
+    {
+      if (threads[i].joinable())
+      {
+        threads[i].join();
+      }
+      all = all && success[i];
+    }
+
+    return all;
+  }
+
+  bool SensorCamera::createCamera(uint32_t index, dwSensorParams paramsClient, const CameraConfig &config)
+  {
+    //------------------------------------------------------------------------------
+    // initializes cameras
+    // -----------------------------------------
+    dwSensorHandle_t camera = DW_NULL_HANDLE;
+    dwStatus status = dwSAL_createSensor(&camera, paramsClient, m_hal);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot create sensor %s with %s. Error: %s", paramsClient.protocol, paramsClient.parameters, dwGetStatusName(status));
+      return false;
+    }
+
+    dwCameraProperties cameraProperties{};
+    status = dwSensorCamera_getSensorProperties(&cameraProperties, camera);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot get sensor properties of camera %u. Error: %s", index, dwGetStatusName(status));
+      dwSAL_releaseSensor(camera);
+      return false;
+    }
+
+    const uint32_t siblings = cameraProperties.siblings > 1 ? cameraProperties.siblings : 1;
+    if (index + siblings > MAX_CAMERAS)
+    {
+      ROS_ERROR("Cannot open %u more cameras, at most %u are supported", siblings, MAX_CAMERAS);
+      dwSAL_releaseSensor(camera);
+      return false;
+    }
+
+    if (siblings > 1 && config.videoCodec != VIDEO_CODEC_NONE)
+    {
+      ROS_ERROR("The encoder is not supported for a camera group");
+      dwSAL_releaseSensor(camera);
+      return false;
+    }
+
+    // timeouts follow the sensor, not a fixed 30 fps budget
+    const int64_t framePeriod = cameraProperties.framerate > 0.0f ? static_cast<int64_t>(1e6 / cameraProperties.framerate) : 0;
+    for (uint32_t s = 0; s < siblings; ++s)
+    {
+      m_health[index + s].initialize(index + s, framePeriod);
+      m_camera[index + s] = camera;
+      m_cameraMaster[index + s] = index;
+      m_sibling[index + s] = s;
+      m_groupSize[index + s] = siblings;
+      m_config[index + s] = config;
+    }
+
+    if (siblings > 1)
+    {
+      ROS_INFO("camera %u opened as group of %u synchronized cameras at %.1f fps", index, siblings, cameraProperties.framerate);
+      m_groupCount++;
+    }
+
+    return true;
+  }
+
+  void SensorCamera::abortRun()
+  {
+    for (uint32_t j = 0; j < m_cameraCount; ++j)
+    {
+      m_encoder[j].stop();
+      if (m_cameraMaster[j] == j)
+      {
+        dwSensor_stop(m_camera[j]);
+      }
+    }
+
+    if (!m_keepPrepared)
+    {
+      releasePrepared();
+    }
+  }
+
+  void SensorCamera::releasePrepared()
+  {
+    for (uint32_t j = 0; j < m_cameraCount; ++j)
+    {
+      releaseCamera(j);
+    }
+    m_cameraCount = 0;
+
+    for (uint32_t i = 0; i < MAX_CAMERAS; ++i)
+    {
+      m_groupBatch[i].publisher.shutdown();
+    }
+
+    m_prepared = false;
+    m_preparedProtocol.clear();
+    m_preparedParams.clear();
+  }
+
+  bool SensorCamera::armCamera(uint32_t index)
+  {
+    // CUDA outputs stop listening for consumers with their camera
+    for (uint32_t o = 0; o < m_outputCount[index]; ++o)
+    {
+      CameraOutput &output = m_output[index][o];
+      if (m_config[index].outputDomain == OUTPUT_DOMAIN_CUDA && !output.eglProducer.isInitialized())
+      {
+        output.cudaPendingCount = 0;
+        if (!output.eglProducer.initialize(output.socketPath, output.width, output.height))
+        {
+          return false;
+        }
+      }
+      resetOutput(index, o);
+    }
+
+    if (m_encoder[index].isEnabled() && !m_encoder[index].start())
+    {
+      return false;
+    }
+
+    m_health[index].initialize(index, m_health[index].getFramePeriod());
+    m_lastConverted[index] = 0;
+    m_counters[index].captured = 0;
+    m_counters[index].converted = 0;
+    m_counters[index].idle = 0;
+    m_counters[index].sensorDropped = 0;
+    m_nextSequence[index] = 0;
+    m_lastStamp[index] = 0;
+    m_statsCaptured[index] = 0;
+    m_stats[index].read.collect();
+    m_stats[index].encode.collect();
+    m_stats[index].convert.collect();
+    m_stats[index].rectify.collect();
+    m_stats[index].tensor.collect();
+
+    return true;
+  }
+
+  bool SensorCamera::startCamera(uint32_t index)
+  {
+    if (!startPipeline(index))
+    {
+      return false;
+    }
+
+    // the encoder reads the native frames next to the conversion
+    if (m_config[index].videoCodec != VIDEO_CODEC_NONE &&
+        !m_encoder[index].initialize(m_camera[index], m_config[index], m_nodeHandle, m_topic[index], m_frameId[index],
+                                     m_clock))
+    {
+      return false;
+    }
+
+    m_captureSlotCount[index] = m_ringDepth + 2;
+    m_captureSlot[index].reset(new CaptureSlot[m_captureSlotCount[index]]);
+    m_captureRing[index].initialize(m_ringDepth);
+
+    return true;
+  }
+
+  bool SensorCamera::startPipeline(uint32_t index)
+  {
+    dwStatus status;
+    dwImageProperties imageProperties{};
+    status = dwSensorCamera_getImageProperties(&imageProperties, DW_CAMERA_OUTPUT_NATIVE_PROCESSED, m_camera[index]);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot get image properties of camera %u. Error: %s", index, dwGetStatusName(status));
+      return false;
+    }
+
+    // publish the processed output as delivered by the sensor
+    if (m_config[index].outputEncoding == OUTPUT_ENCODING_NATIVE)
+    {
+      if (imageProperties.format == DW_IMAGE_FORMAT_YUV420_UINT8_PLANAR)
+      {
+        m_config[index].outputEncoding = OUTPUT_ENCODING_YUV420;
+      }
+      else if (imageProperties.format == DW_IMAGE_FORMAT_YUV420_UINT8_SEMIPLANAR)
+      {
+        m_config[index].outputEncoding = OUTPUT_ENCODING_NV12;
+      }
+      else
+      {
+        ROS_ERROR("Native format %d of camera %u cannot be published", imageProperties.format, index);
+        return false;
+      }
+    }
+
+    const OutputEncoding encoding = m_config[index].outputEncoding;
+    const bool convert = imageProperties.format != getImageFormat(encoding);
+    const dwImageProperties nativeProperties = imageProperties;
+    imageProperties.format = getImageFormat(encoding);
+    ROS_INFO("camera %u publishes %s, %s", index, getEncodingName(encoding), convert ? "converted" : "native format");
+
+    // the siblings of a group share one converted pass, a rectifier per sibling is not supported yet
+    const bool rectify = m_config[index].rectify;
+    if (rectify && m_groupSize[index] > 1)
+    {
+      ROS_ERROR("rectify=true is not supported for the siblings of camera group %u", m_cameraMaster[index]);
+      return false;
+    }
+
+    // without output options the frame is published at half size on the camera topic, rectified on <topic>/image_rect
+    std::vector<OutputConfig> outputs = m_config[index].outputs;
+    if (outputs.empty())
+    {
+      OutputConfig output;
+      output.name = rectify ? "image_rect" : "";
+      output.width = imageProperties.width / 2;
+      output.height = imageProperties.height / 2;
+      outputs.push_back(output);
+    }
+
+    // a policy for an output which does not exist is a typo, not a default
+    for (const BackpressureConfig &backpressure : m_config[index].backpressure)
+    {
+      bool found = backpressure.output.empty();
+      for (const OutputConfig &output : outputs)
+      {
+        found = found || output.name == backpressure.output;
+      }
+      if (!found)
+      {
+        ROS_ERROR("backpressure names unknown output %s of camera %u", backpressure.output.c_str(), index);
+        return false;
+      }
+    }
+
+    bool transform = false;
+    uint32_t generic = 0;
+    m_outputCount[index] = static_cast<uint32_t>(outputs.size());
+    for (uint32_t o = 0; o < m_outputCount[index]; ++o)
+    {
+      CameraOutput &output = m_output[index][o];
+      output.config = outputs[o];
+
+      output.roi = {0, 0, static_cast<int32_t>(imageProperties.width), static_cast<int32_t>(imageProperties.height)};
+      if (output.config.cropWidth > 0)
+      {
+        if (output.config.cropX + output.config.cropWidth > imageProperties.width ||
+            output.config.cropY + output.config.cropHeight > imageProperties.height)
+        {
+          ROS_ERROR("Crop %ux%u+%u+%u of output %s exceeds the %ux%u frame of camera %u", output.config.cropWidth,
+                    output.config.cropHeight, output.config.cropX, output.config.cropY, output.config.name.c_str(),
+                    imageProperties.width, imageProperties.height, index);
+
+          return false;
+        }
+        output.roi = {static_cast<int32_t>(output.config.cropX), static_cast<int32_t>(output.config.cropY),
+                      static_cast<int32_t>(output.config.cropWidth), static_cast<int32_t>(output.config.cropHeight)};
+      }
+
+      output.width = output.config.width > 0 ? output.config.width : static_cast<uint32_t>(output.roi.width);
+      output.height = output.config.height > 0 ? output.config.height : static_cast<uint32_t>(output.roi.height);
+      output.transform = output.width != imageProperties.width || output.height != imageProperties.height ||
+                         output.roi.x != 0 || output.roi.y != 0;
+
+      // a plain downscale of a native CUDA frame skips the full size conversion
+      output.fusedScale = 0;
+      const bool rgb =
+          imageProperties.format == DW_IMAGE_FORMAT_RGBA_UINT8 || imageProperties.format == DW_IMAGE_FORMAT_RGB_UINT8;
+      if (m_fusedConvert && convert && rgb && !rectify && output.config.cropWidth == 0 &&
+          nativeProperties.type == DW_IMAGE_CUDA && getFusedFormat(nativeProperties.format, output.fusedFormat))
+      {
+        output.fusedScale =
+            getConversionScale(imageProperties.width, imageProperties.height, output.width, output.height);
+      }
+      if (output.fusedScale > 0)
+      {
+        ROS_INFO("camera %u output %s converted and resized to 1/%d in one kernel", index, output.config.name.c_str(),
+                 output.fusedScale);
+      }
+      else
+      {
+        generic++;
+        transform = transform || output.transform;
+      }
+    }
+
+    // a single untransformed output is converted straight into its streamer target,
+    // otherwise all outputs which are not fused read one full size conversion
+    if (convert && (generic > 1 || transform || rectify))
+    {
+      status = dwImage_create(&m_convertedFrame[index], imageProperties, m_sdk);
+      if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("Cannot create converted image of camera %u. Error: %s", index, dwGetStatusName(status));
+
+        return false;
+      }
+    }
+
+    // the outputs crop and resize the rectified CUDA frame instead
+    if (rectify)
+    {
+      if (!m_rectifier[index].initialize(m_sdk, m_rigPath, m_config[index], imageProperties))
+      {
+        return false;
+      }
+      imageProperties.type = DW_IMAGE_CUDA;
+    }
+
+    // initialize the image transformation shared by the outputs
+    if (transform)
+    {
+      dwImageTransformationParameters m_params{false};
+      m_params.ignoreAspectRatio = false;
+
+      status = dwImageTransformation_initialize(&m_imageTransformationEngine[index], m_params, m_sdk);
+      if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("Cannot initialize image transformation of camera %u. Error: %s", index, dwGetStatusName(status));
+        m_imageTransformationEngine[index] = DW_NULL_HANDLE;
+        return false;
+      }
+      dwImageTransformation_setBorderMode(DW_IMAGEPROCESSING_BORDER_MODE_ZERO, m_imageTransformationEngine[index]);
+      dwImageTransformation_setInterpolationMode(DW_IMAGEPROCESSING_INTERPOLATION_DEFAULT, m_imageTransformationEngine[index]);
+    }
+
+    for (uint32_t o = 0; o < m_outputCount[index]; ++o)
+    {
+      if (!startOutput(index, o, imageProperties))
+      {
+        return false;
+      }
+    }
+    m_lastConverted[index] = 0;
+
+    return true;
+  }
+
+  void SensorCamera::advertiseOutputs(uint32_t index)
+  {
+    if (!m_config[index].rawOutput)
+    {
+      return;
+    }
+
+    for (uint32_t o = 0; o < m_outputCount[index]; ++o)
+    {
+      CameraOutput &output = m_output[index][o];
+      if (m_rectifier[index].isEnabled())
+      {
+        output.infoPub = m_nodeHandle.advertise<sensor_msgs::CameraInfo>(output.topic + "/camera_info", 1);
+        ROS_INFO("camera %u intrinsics being published on topic /%s/camera_info", index, output.topic.c_str());
+      }
+      if (m_config[index].outputDomain == OUTPUT_DOMAIN_CUDA)
+      {
+        output.cudaPub = m_nodeHandle.advertise<nv_sensors::CudaFrame>(output.topic + "/cuda", 1);
+        ROS_INFO("camera %u frame descriptors being published on topic /%s/cuda", index, output.topic.c_str());
+        continue;
+      }
+
+      output.cameraPub = m_nodeHandle.advertise<sensor_msgs::Image>(output.topic, 1);
+      ROS_INFO("camera %u data being published on topic /%s", index, output.topic.c_str());
+      if (output.shmRing.isOpen())
+      {
+        output.shmPub = m_nodeHandle.advertise<nv_sensors::ShmImage>(output.topic + "/shm", 1);
+        ROS_INFO("camera %u shared-memory descriptors being published on topic /%s/shm", index, output.topic.c_str());
+      }
+    }
+  }
+
+  void SensorCamera::startPipelineThreads(uint32_t index)
+  {
+    if (m_config[index].rawOutput)
+    {
+      for (uint32_t o = 0; o < m_outputCount[index]; ++o)
+      {
+        const std::string suffix = std::to_string(index) + "_" + std::to_string(o);
+        m_output[index][o].publishThread = std::thread(&SensorCamera::run_publish, this, index, o);
+        applyThreadPolicy(m_output[index][o].publishThread, m_publishPolicy, index, "nv_pub_" + suffix);
+        m_output[index][o].receiveThread = std::thread(&SensorCamera::run_receive, this, index, o);
+        applyThreadPolicy(m_output[index][o].receiveThread, m_publishPolicy, index, "nv_recv_" + suffix);
+      }
+    }
+
+    // a group with a tensor converts every pass on the convert stage of its master
+    if (!m_groupPass[m_cameraMaster[index]])
+    {
+      m_convertThread[index] = std::thread(&SensorCamera::run_convert, this, index);
+    }
+    else if (m_cameraMaster[index] == index)
+    {
+      m_convertThread[index] = std::thread(&SensorCamera::run_convertGroup, this, index);
+    }
+    if (m_convertThread[index].joinable())
+    {
+      applyThreadPolicy(m_convertThread[index], m_convertPolicy, index, "nv_convert_" + std::to_string(index));
+    }
+  }
+
+  void SensorCamera::stopPipelineThreads(uint32_t index)
+  {
+    m_pipelineRun[index] = false;
+    m_captureRing[index].wake();
+    for (uint32_t o = 0; o < m_outputCount[index]; ++o)
+    {
+      m_output[index][o].publishRing.wake();
+    }
+
+    if (m_convertThread[index].joinable())
+      m_convertThread[index].join();
+    for (uint32_t o = 0; o < m_outputCount[index]; ++o)
+    {
+      if (m_output[index][o].receiveThread.joinable())
+        m_output[index][o].receiveThread.join();
+      if (m_output[index][o].publishThread.joinable())
+        m_output[index][o].publishThread.join();
+    }
+  }
+
+  bool SensorCamera::reconfigure(uint32_t index, const std::string &params)
+  {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    if (!m_cameraRun)
+    {
+      ROS_WARN("CAMERA sensor not running");
+      return false;
+    }
+
+    if (index >= m_cameraCount)
+    {
+      ROS_ERROR("Cannot reconfigure camera %u, %u camera(s) running", index, m_cameraCount);
+      return false;
+    }
+
+    if (m_groupPass[m_cameraMaster[index]])
+    {
+      ROS_ERROR("Cannot reconfigure camera %u, its group is converted into one tensor", index);
+      return false;
+    }
+
+    // options not given keep their value, output= options replace all outputs and the backpressure naming them
+    CameraConfig config = m_config[index];
+    config.outputs.clear();
+    config.backpressure.clear();
+    std::string sensorParams;
+    if (!parseCameraConfig(params, config, sensorParams))
+    {
+      ROS_ERROR("Invalid output options for camera %u: %s", index, params.c_str());
+      return false;
+    }
+    if (config.outputs.empty())
+    {
+      // the new policies come last and win over the previous ones
+      config.outputs = m_config[index].outputs;
+      config.backpressure.insert(config.backpressure.begin(), m_config[index].backpressure.begin(),
+                                 m_config[index].backpressure.end());
+    }
+
+    if (!sensorParams.empty())
+    {
+      ROS_ERROR("Sensor parameters %s need a restart of camera %u", sensorParams.c_str(), index);
+      return false;
+    }
+
+    // the serializer and the tensor are bound to the sensor
+    const CameraConfig &current = m_config[index];
+    if (config.videoCodec != current.videoCodec || config.encoderBitrate != current.encoderBitrate ||
+        config.encoderGop != current.encoderGop || config.encoderFramerate != current.encoderFramerate ||
+        config.tensorLayout != current.tensorLayout || config.frameId != current.frameId)
+    {
+      ROS_ERROR("Encoder, tensor and frame-id options need a restart of camera %u", index);
+      return false;
+    }
+
+    // the sensor keeps streaming into the capture ring, which hands the oldest frames back meanwhile
+    ROS_INFO("reconfiguring camera %u with %s", index, params.c_str());
+    stopPipelineThreads(index);
+    for (uint32_t o = 0; o < m_outputCount[index]; ++o)
+    {
+      drainOutput(index, o);
+    }
+    releasePipeline(index);
+
+    const CameraConfig previous = m_config[index];
+    m_config[index] = config;
+    bool success = startPipeline(index);
+    if (!success)
+    {
+      ROS_ERROR("Reconfiguration of camera %u failed, restoring the previous outputs", index);
+      releasePipeline(index);
+      m_config[index] = previous;
+      if (!startPipeline(index))
+      {
+        ROS_ERROR("Cannot restore the outputs of camera %u, it is only captured", index);
+        releasePipeline(index);
+      }
+    }
+
+    advertiseOutputs(index);
+    m_pipelineRun[index] = true;
+    startPipelineThreads(index);
+
+    return success;
+  }
+
+  bool SensorCamera::startRecording(const std::vector<uint32_t> &cameras, const std::string &directory,
+                                    const std::string &format)
+  {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    if (!m_cameraRun)
+    {
+      ROS_WARN("CAMERA sensor not running");
+      return false;
+    }
+
+    const std::string recordFormat = format.empty() ? "h264" : format;
+    if (recordFormat != "h264" && recordFormat != "h265" && recordFormat != "raw")
+    {
+      ROS_ERROR("Invalid record format %s, expected h264, h265 or raw", recordFormat.c_str());
+      return false;
+    }
+
+    int segmentSize;
+    m_privateNodeHandle.param("record_segment_size", segmentSize, static_cast<int>(CameraRecorder::DEFAULT_SEGMENT_SIZE >> 20));
+    if (segmentSize < 1)
+    {
+      ROS_WARN("Invalid record_segment_size %d, using %lu", segmentSize, CameraRecorder::DEFAULT_SEGMENT_SIZE >> 20);
+      segmentSize = static_cast<int>(CameraRecorder::DEFAULT_SEGMENT_SIZE >> 20);
+    }
+
+    // the siblings of a group share the sensor handle of their master, a serializer per sibling is not supported
+    std::vector<uint32_t> indices = cameras;
+    if (indices.empty())
+    {
+      for (uint32_t i = 0; i < m_cameraCount; ++i)
+      {
+        if (m_groupSize[i] > 1)
+        {
+          ROS_WARN("Recording is not supported for camera group %u, camera %u is not recorded", m_cameraMaster[i], i);
+          continue;
+        }
+        indices.push_back(i);
+      }
+    }
+    for (uint32_t index : indices)
+    {
+      if (index >= m_cameraCount)
+      {
+        ROS_ERROR("Cannot record camera %u, %u camera(s) running", index, m_cameraCount);
+        return false;
+      }
+      if (m_groupSize[index] > 1)
+      {
+        ROS_ERROR("Cannot record camera %u, recording is not supported for camera group %u", index,
+                  m_cameraMaster[index]);
+        return false;
+      }
+    }
+
+    if (directory.empty() || (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST))
+    {
+      ROS_ERROR("Cannot create record directory %s. Error: %s", directory.c_str(), strerror(errno));
+      return false;
+    }
+
+    bool success = true;
+    for (uint32_t index : indices)
+    {
+      std::string name = m_topic[index];
+      std::replace(name.begin(), name.end(), '/', '_');
+      success = m_recorder[index].start(m_camera[index], m_config[index], directory + "/" + name, recordFormat,
+                                        static_cast<uint64_t>(segmentSize) << 20) &&
+                success;
+    }
+
+    return success;
+  }
+
+  bool SensorCamera::stopRecording(const std::vector<uint32_t> &cameras)
+  {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    bool success = true;
+    for (uint32_t index : cameras)
+    {
+      if (index >= m_cameraCount)
+      {
+        ROS_ERROR("Cannot stop recording camera %u, %u camera(s) running", index, m_cameraCount);
+        success = false;
+        continue;
+      }
+      m_recorder[index].stop();
+    }
+
+    if (cameras.empty())
+    {
+      for (uint32_t i = 0; i < m_cameraCount; ++i)
+      {
+        m_recorder[i].stop();
+      }
+    }
+
+    return success;
+  }
+
+  bool SensorCamera::startOutput(uint32_t index, uint32_t o, dwImageProperties imageProperties)
+  {
+    CameraOutput &output = m_output[index][o];
+    const OutputEncoding encoding = m_config[index].outputEncoding;
+
+    output.topic = m_topic[index];
+    output.socketPath = m_socketPath[index];
+    if (!output.config.name.empty())
+    {
+      output.topic += "/" + output.config.name;
+      output.socketPath += "_" + output.config.name;
+    }
+    if (m_rectifier[index].isEnabled())
+    {
+      initCameraInfo(index, o);
+    }
+
+    imageProperties.width = output.width;
+    imageProperties.height = output.height;
+    ROS_INFO("camera %u output /%s %ux%u from %dx%d+%d+%d", index, output.topic.c_str(), output.width, output.height,
+             output.roi.width, output.roi.height, output.roi.x, output.roi.y);
+
+    // one streamer target per in-flight frame, CUDA frames are also held by the EGLStream
+    output.streamTargets = static_cast<uint32_t>(m_streamerDepth);
+    if (m_config[index].outputDomain == OUTPUT_DOMAIN_CUDA)
+    {
+      output.streamTargets += EGL_STREAM_FRAMES;
+    }
+    dwStatus status;
+    for (uint32_t k = 0; k < output.streamTargets; ++k)
+    {
+      status = dwImage_create(&output.streamImage[k], imageProperties, m_sdk);
+      if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("Cannot create streamer target %u of camera %u output %u. Error: %s", k, index, o, dwGetStatusName(status));
+        output.streamImage[k] = DW_NULL_HANDLE;
+        return false;
+      }
+    }
+    // setup streamer for frame grabbing
+    dwImageType streamType = m_config[index].outputDomain == OUTPUT_DOMAIN_CUDA ? DW_IMAGE_CUDA : DW_IMAGE_CPU;
+    status = dwImageStreamer_initialize(&output.streamer, &imageProperties, streamType, m_sdk);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot initialize streamer of camera %u output %u. Error: %s", index, o, dwGetStatusName(status));
+      output.streamer = DW_NULL_HANDLE;
+      return false;
+    }
+
+    // share the CUDA frames with co-located consumers
+    if (m_config[index].outputDomain == OUTPUT_DOMAIN_CUDA)
+    {
+      output.cudaPendingCount = 0;
+      if (!output.eglProducer.initialize(output.socketPath, output.width, output.height))
+      {
+        return false;
+      }
+    }
+
+    output.imagePool.initialize(m_poolDepth, getEncodingName(encoding), output.width, output.height,
+                                getPixelSize(encoding) * output.width,
+                                getFrameSize(encoding, output.width, output.height), m_frameId[index]);
+    output.publishRing.initialize(m_ringDepth);
+    output.backpressure = findBackpressure(m_config[index], output.config.name);
+
+    // subscribers of the shm transport read the packed frames in place
+    if (m_config[index].outputDomain == OUTPUT_DOMAIN_CPU && m_shmSlots > 0 &&
+        !output.shmRing.create(ShmRing::getSegmentName(output.topic + "/shm"), m_shmSlots,
+                               getFrameSize(encoding, output.width, output.height)))
+    {
+      return false;
+    }
+    resetOutput(index, o);
+
+    return true;
+  }
+
+  void SensorCamera::resetOutput(uint32_t index, uint32_t o)
+  {
+    CameraOutput &output = m_output[index][o];
+
+    // every target is back from the streamer
+    output.streamFreeCount = 0;
+    for (uint32_t k = 0; k < output.streamTargets; ++k)
+    {
+      output.streamFree[output.streamFreeCount++] = output.streamImage[k];
+    }
+    output.streamSent = 0;
+    output.streamReceived = 0;
+    for (uint32_t k = 0; k < MAX_STREAMER_TARGETS; ++k)
+    {
+      output.sendTime[k] = 0;
+    }
+
+    output.offered = 0;
+    output.lastConverted = 0;
+    output.counters.skipped = 0;
+    output.counters.decimated = 0;
+    output.counters.convertDropped = 0;
+    output.counters.received = 0;
+    output.counters.receiveDropped = 0;
+    output.counters.ringRejected = 0;
+    output.counters.deadlineMissed = 0;
+    output.counters.published = 0;
+    output.counters.shmPublished = 0;
+    output.statsPublished = 0;
+    output.stats.transform.collect();
+    output.stats.send.collect();
+    output.stats.stream.collect();
+    output.stats.copy.collect();
+    output.stats.publish.collect();
+    output.stats.latency.collect();
+  }
+
+  void SensorCamera::releaseCamera(uint32_t index)
+  {
+    m_recorder[index].stop();
+    m_encoder[index].release();
+    m_tensor[index].release();
+    m_groupPass[index].reset();
+    m_groupPassCount[index] = 0;
+    m_captureSlot[index].reset();
+    m_captureSlotCount[index] = 0;
+
+    releasePipeline(index);
+
+    // siblings share the sensor of their master
+    if (m_camera[index] && m_cameraMaster[index] == index)
+    {
+      dwSAL_releaseSensor(m_camera[index]);
+    }
+    m_camera[index] = DW_NULL_HANDLE;
+  }
+
+  void SensorCamera::releasePipeline(uint32_t index)
+  {
+    for (uint32_t o = 0; o < MAX_OUTPUTS; ++o)
+    {
+      releaseOutput(index, o);
+    }
+    m_outputCount[index] = 0;
+
+    if (m_convertedFrame[index])
+    {
+      dwImage_destroy(m_convertedFrame[index]);
+      m_convertedFrame[index] = DW_NULL_HANDLE;
+    }
+    m_rectifier[index].release();
+
+    if (m_imageTransformationEngine[index])
+    {
+      dwImageTransformation_release(m_imageTransformationEngine[index]);
+      m_imageTransformationEngine[index] = DW_NULL_HANDLE;
+    }
+  }
+
+  void SensorCamera::releaseOutput(uint32_t index, uint32_t o)
+  {
+    CameraOutput &output = m_output[index][o];
+
+    output.eglProducer.release();
+
+    if (output.streamer)
+    {
+      dwImageStreamer_release(output.streamer);
+      output.streamer = DW_NULL_HANDLE;
+    }
+
+    for (uint32_t k = 0; k < MAX_STREAMER_TARGETS; ++k)
+    {
+      if (output.streamImage[k])
+      {
+        dwImage_destroy(output.streamImage[k]);
+      }
+      output.streamImage[k] = DW_NULL_HANDLE;
+    }
+
+    output.imagePool.release();
+
+    output.cameraPub.shutdown();
+    output.cudaPub.shutdown();
+    output.shmPub.shutdown();
+    output.shmRing.release();
+    output.infoPub.shutdown();
+  }
+
+  void SensorCamera::drainOutput(uint32_t index, uint32_t o)
+  {
+    CameraOutput &output = m_output[index][o];
+
+    // frames still inside the EGLStream or the streamer
+    output.eglProducer.release();
+    reclaimCudaFrames(index, o);
+
+    dwImageHandle_t streamedFrame;
+    while (dwImageStreamer_consumerReceive(&streamedFrame, 0, output.streamer) == DW_SUCCESS)
+    {
+      dwImageStreamer_consumerReturn(&streamedFrame, output.streamer);
+    }
+    while (output.streamFreeCount < output.streamTargets)
+    {
+      dwImageHandle_t returned = DW_NULL_HANDLE;
+      if (dwImageStreamer_producerReturn(&returned, m_health[index].getFramePeriod(), output.streamer) != DW_SUCCESS)
+      {
+        break;
+      }
+      output.streamFree[output.streamFreeCount++] = returned;
+    }
+
+    Image *queued;
+    while (output.publishRing.pop(queued))
+    {
+      output.imagePool.recycle(queued);
+    }
+
+    ROS_INFO("camera %u output /%s skipped %lu, decimated %lu, convert dropped %lu, received %lu (no free message %lu), "
+             "published %lu (publish ring dropped %lu, rejected %lu, deadline missed %lu)",
+             index, output.topic.c_str(), output.counters.skipped.load(), output.counters.decimated.load(),
+             output.counters.convertDropped.load(), output.counters.received.load(),
+             output.counters.receiveDropped.load(), output.counters.published.load(), output.publishRing.getDropped(),
+             output.counters.ringRejected.load(), output.counters.deadlineMissed.load());
+  }
+
+  bool SensorCamera::stop()
+  {
+    if (!m_cameraRun)
+    {
+      ROS_WARN("CAMERA sensor not running");
+      return false;
+    }
+
+    m_cameraRun = false;
+    stopTimers();
+
+    for (uint32_t i = 0; i < m_cameraCount; ++i)
+    {
+      m_captureRing[i].wake();
+      m_groupRing[i].wake();
+      for (uint32_t o = 0; o < m_outputCount[i]; ++o)
+      {
+        m_output[i][o].publishRing.wake();
+      }
+
+      if (m_cameraThread[i].joinable())
+        m_cameraThread[i].join();
+      if (m_convertThread[i].joinable())
+        m_convertThread[i].join();
+      for (uint32_t o = 0; o < m_outputCount[i]; ++o)
+      {
+        if (m_output[i][o].receiveThread.joinable())
+          m_output[i][o].receiveThread.join();
+        if (m_output[i][o].publishThread.joinable())
+          m_output[i][o].publishThread.join();
+      }
+    }
+
+    // hand frames still queued between the stages back to their owners, siblings share one sensor
+    for (uint32_t i = 0; i < m_cameraCount; ++i)
+    {
+      CapturedFrame captured;
+      while (m_captureSlot[i] && popCaptured(i, captured, 0))
+      {
+        dwSensorCamera_returnFrame(&captured.frame);
+      }
+
+      GroupPass *pass;
+      while (m_groupPass[i] && m_groupRing[i].pop(pass))
+      {
+        releasePass(pass, m_groupSize[i]);
+      }
+    }
+
+    for (uint32_t i = 0; i < m_cameraCount; ++i)
+    {
+      ROS_INFO("camera %u captured %lu (capture ring dropped %lu), converted %lu (no subscriber %lu)", i,
+               m_counters[i].captured.load(), m_captureRing[i].getDropped(), m_counters[i].converted.load(),
+               m_counters[i].idle.load());
+
+      for (uint32_t o = 0; o < m_outputCount[i]; ++o)
+      {
+        drainOutput(i, o);
+      }
+
+      // the serializers stop before their sensor
+      m_recorder[i].stop();
+      m_encoder[i].stop();
+      if (m_cameraMaster[i] == i)
+      {
+        dwSensor_stop(m_camera[i]);
+      }
+    }
+
+    for (uint32_t i = 0; i < MAX_CAMERAS; ++i)
+    {
+      GroupBatch &batch = m_groupBatch[i];
+      for (uint32_t s = 0; s < MAX_CAMERAS; ++s)
+      {
+        batch.images[s].reset();
+      }
+      batch.seq = 0;
+      batch.count = 0;
+    }
+
+    // prepared cameras keep their images, streamers and pools for the next start
+    if (m_keepPrepared)
+    {
+      ROS_INFO("%u camera(s) stopped, still prepared", m_cameraCount);
+      return true;
+    }
+    releasePrepared();
+
+    return true;
+  }
+
+  void SensorCamera::run_capture(uint32_t index)
+  {
+    const PipelineClock::duration period = m_captureRate > 0.0
+                                               ? std::chrono::duration_cast<PipelineClock::duration>(std::chrono::duration<double>(1.0 / m_captureRate))
+                                               : PipelineClock::duration::zero();
+    PipelineClock::time_point next = PipelineClock::now();
+
+    while (m_cameraRun)
+    {
+      // replay at a fixed rate (~capture_rate), a late frame restarts the schedule
+      if (m_captureRate > 0.0)
+      {
+        next += period;
+        if (next > PipelineClock::now())
+        {
+          std::this_thread::sleep_until(next);
+        }
+        else
+        {
+          next = PipelineClock::now();
+        }
+      }
+
+      if (m_groupSize[index] > 1)
+      {
+        if (!captureGroup(index))
+        {
+          break;
+        }
+        continue;
+      }
+
+      dwCameraFrameHandle_t frame;
+      const PipelineClock::time_point start = PipelineClock::now();
+      dwStatus status = dwSensorCamera_readFrameNew(&frame, m_health[index].getReadTimeout(), m_camera[index]);
+      if (status == DW_END_OF_STREAM)
+      {
+        ROS_WARN("camera sensor end of stream reached.");
+        break;
+      }
+      else if (status == DW_TIME_OUT || status == DW_NOT_READY)
+      {
+        backoff(m_health[index].onMissed(dwGetStatusName(status), status == DW_TIME_OUT));
+        continue;
+      }
+
+      if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("camera sensor readFrame failed. Error: %s", dwGetStatusName(status));
+        break;
+      }
+
+      ROS_DEBUG("camera sensor readFrame success.");
+      m_health[index].onFrame();
+      dwTime_t timestamp = 0;
+      dwSensorCamera_getTimestamp(&timestamp, frame);
+      pushFrame(index, frame, timestamp, nextSequence(index, timestamp), start);
+    }
+  }
+
+  void SensorCamera::backoff(int64_t us)
+  {
+    // in slices, so a stop request is not held up by a stalled camera
+    const PipelineClock::time_point end = PipelineClock::now() + std::chrono::microseconds(us);
+    while (m_cameraRun && PipelineClock::now() < end)
+    {
+      std::this_thread::sleep_for(std::min(std::chrono::duration_cast<PipelineClock::duration>(std::chrono::milliseconds(100)),
+                                           end - PipelineClock::now()));
+    }
+  }
+
+  bool SensorCamera::captureGroup(uint32_t index)
+  {
+    // one blocking read per sibling, every frame of the pass gets the stamp of the first one read
+    const uint32_t siblings = m_groupSize[index];
+    GroupPass *pass = nullptr;
+    if (m_groupPass[index])
+    {
+      pass = acquirePass(index);
+      if (!pass)
+      {
+        ROS_ERROR("camera group %u has no free capture pass", index);
+        return false;
+      }
+    }
+
+    dwTime_t timestamp = 0;
+    uint32_t seq = 0;
+    const char *missed = nullptr;
+    bool waited = false;
+    for (uint32_t s = 0; s < siblings; ++s)
+    {
+      dwCameraFrameHandle_t frame;
+      const PipelineClock::time_point start = PipelineClock::now();
+      dwStatus status = dwSensorCamera_readFrame(&frame, s, m_health[index + s].getReadTimeout(), m_camera[index]);
+      if (status == DW_END_OF_STREAM)
+      {
+        ROS_WARN("camera group %u end of stream reached.", index);
+        releasePass(pass, s);
+        return false;
+      }
+      else if (status == DW_TIME_OUT || status == DW_NOT_READY)
+      {
+        // a sibling which stopped delivering is tracked on its own, the pass backs off only if all did
+        missed = dwGetStatusName(status);
+        waited = waited || status == DW_TIME_OUT;
+        if (s > 0)
+        {
+          m_health[index + s].onMissed(missed, status == DW_TIME_OUT);
+        }
+        continue;
+      }
+      else if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("camera group %u sibling %u readFrame failed. Error: %s", index, s, dwGetStatusName(status));
+        releasePass(pass, s);
+        return false;
+      }
+
+      if (timestamp == 0)
+      {
+        dwSensorCamera_getTimestamp(&timestamp, frame);
+        seq = nextSequence(index, timestamp);
+      }
+      if (s > 0)
+      {
+        m_health[index + s].onFrame();
+      }
+
+      if (!pass)
+      {
+        pushFrame(index + s, frame, timestamp, seq, start);
+        continue;
+      }
+      m_stats[index + s].read.record(start);
+      m_counters[index + s].captured++;
+      pass->frames[s] = frame;
+    }
+
+    // the master slot tracks the group as a whole
+    if (timestamp == 0)
+    {
+      releasePass(pass, siblings);
+      backoff(m_health[index].onMissed(missed ? missed : "no frame", waited));
+      return true;
+    }
+    m_health[index].onFrame();
+
+    if (pass)
+    {
+      // a full ring hands the oldest pass back, as for single frames
+      pass->timestamp = timestamp;
+      pass->seq = seq;
+      GroupPass *evicted;
+      if (m_groupRing[index].push(pass, evicted))
+      {
+        releasePass(evicted, siblings);
+      }
+    }
+
+    return true;
+  }
+
+  SensorCamera::GroupPass *SensorCamera::acquirePass(uint32_t index)
+  {
+    for (uint32_t p = 0; p < m_groupPassCount[index]; ++p)
+    {
+      GroupPass &pass = m_groupPass[index][p];
+      if (!pass.busy.load(std::memory_order_acquire))
+      {
+        for (uint32_t s = 0; s < MAX_CAMERAS; ++s)
+        {
+          pass.frames[s] = DW_NULL_HANDLE;
+        }
+        pass.timestamp = 0;
+        pass.busy.store(true, std::memory_order_relaxed);
+        return &pass;
+      }
+    }
+
+    return nullptr;
+  }
+
+  void SensorCamera::releasePass(GroupPass *pass, uint32_t siblings)
+  {
+    if (!pass)
+    {
+      return;
+    }
+
+    for (uint32_t s = 0; s < siblings; ++s)
+    {
+      if (pass->frames[s])
+      {
+        dwSensorCamera_returnFrame(&pass->frames[s]);
+        pass->frames[s] = DW_NULL_HANDLE;
+      }
+    }
+    pass->busy.store(false, std::memory_order_release);
+  }
+
+  uint32_t SensorCamera::nextSequence(uint32_t index, dwTime_t timestamp)
+  {
+    // a gap of several frame periods between two stamps numbers the frames the sensor skipped
+    uint32_t step = 1;
+    const int64_t period = m_health[index].getFramePeriod();
+    if (m_lastStamp[index] != 0 && timestamp > m_lastStamp[index] && period > 0)
+    {
+      const int64_t frames = (timestamp - m_lastStamp[index] + period / 2) / period;
+      if (frames > 1)
+      {
+        step = static_cast<uint32_t>(frames);
+        m_counters[index].sensorDropped += step - 1;
+      }
+    }
+    const bool first = m_lastStamp[index] == 0;
+    m_lastStamp[index] = timestamp;
+
+    // the first frame is number 0
+    const uint32_t seq = first ? 0 : m_nextSequence[index] + step - 1;
+    m_nextSequence[index] = seq + 1;
+
+    return seq;
+  }
+
+  void SensorCamera::pushFrame(uint32_t index, dwCameraFrameHandle_t frame, dwTime_t timestamp, uint32_t seq,
+                               const PipelineClock::time_point &start)
+  {
+    m_stats[index].read.record(start);
+    m_counters[index].captured++;
+
+    // a free slot always exists while the ring is full and the convert stage copies another
+    CaptureSlot *slot = nullptr;
+    uint32_t s = 0;
+    for (; s < m_captureSlotCount[index]; ++s)
+    {
+      if (!m_captureSlot[index][s].busy.load(std::memory_order_acquire))
+      {
+        slot = &m_captureSlot[index][s];
+        break;
+      }
+    }
+    if (!slot)
+    {
+      dwSensorCamera_returnFrame(&frame);
+      return;
+    }
+    slot->captured = {frame, timestamp, seq};
+    slot->busy.store(true, std::memory_order_relaxed);
+
+    // never wait for the convert stage, a full ring hands the oldest frame back to the driver
+    uint32_t evicted;
+    if (m_captureRing[index].push(s, evicted))
+    {
+      CaptureSlot &oldest = m_captureSlot[index][evicted];
+      dwSensorCamera_returnFrame(&oldest.captured.frame);
+      oldest.busy.store(false, std::memory_order_release);
+    }
+  }
+
+  bool SensorCamera::popCaptured(uint32_t index, CapturedFrame &captured, int64_t timeoutUs)
+  {
+    uint32_t s;
+    if (!(timeoutUs > 0 ? m_captureRing[index].waitPop(s, timeoutUs) : m_captureRing[index].pop(s)))
+    {
+      return false;
+    }
+
+    // popped slots cannot be evicted, so the copy is not raced by the capture stage
+    CaptureSlot &slot = m_captureSlot[index][s];
+    captured = slot.captured;
+    slot.busy.store(false, std::memory_order_release);
+
+    return true;
+  }
+
+  void SensorCamera::run_convert(uint32_t index)
+  {
+    while (isPipelineRunning(index))
+    {
+      CapturedFrame captured;
+      if (!popCaptured(index, captured, m_health[index].getFramePeriod()))
+      {
+        continue;
+      }
+
+      bool success = true;
+      if (m_encoder[index].isEnabled())
+      {
+        const PipelineClock::time_point start = PipelineClock::now();
+        success = m_encoder[index].encode(captured.frame, captured.seq);
+        m_stats[index].encode.record(start);
+      }
+      if (m_recorder[index].isRecording())
+      {
+        m_recorder[index].record(captured.frame);
+      }
+      // the copy out of the capture slot carries the resolved stamp and the sequence number on
+      if (captured.timestamp == 0)
+      {
+        dwSensorCamera_getTimestamp(&captured.timestamp, captured.frame);
+      }
+      if (success && m_tensor[index].isEnabled())
+      {
+        success = convertTensor(index, &captured.frame, captured.timestamp, captured.seq);
+      }
+      if (success && m_config[index].rawOutput && isConversionDue(index, captured.timestamp))
+      {
+        success = convertFrame(index, captured);
+      }
+      dwSensorCamera_returnFrame(&captured.frame);
+
+      if (!success)
+      {
+        break;
+      }
+    }
+  }
+
+  // frames closer than one interval minus half a frame period to the last converted one are not due
+  static bool isRateDue(float rate, dwTime_t &lastConverted, dwTime_t timestamp, int64_t framePeriodUs)
+  {
+    if (rate > 0.0f && lastConverted != 0)
+    {
+      const int64_t interval = static_cast<int64_t>(1e6 / rate);
+      if (timestamp - lastConverted < interval - framePeriodUs / 2)
+      {
+        return false;
+      }
+    }
+
+    lastConverted = timestamp;
+    return true;
+  }
+
+  bool SensorCamera::isConversionDue(uint32_t index, dwTime_t timestamp)
+  {
+    // publish-rate of the camera, applies to all outputs
+    return isRateDue(m_config[index].publishRate, m_lastConverted[index], timestamp, m_health[index].getFramePeriod());
+  }
+
+  bool SensorCamera::isOutputDue(uint32_t index, uint32_t o, dwTime_t timestamp)
+  {
+    CameraOutput &output = m_output[index][o];
+
+    // /<N>, every N-th frame offered to the output
+    if (output.offered++ % output.config.decimation != 0)
+    {
+      return false;
+    }
+
+    // @<Hz>
+    return isRateDue(output.config.rate, output.lastConverted, timestamp, m_health[index].getFramePeriod());
+  }
+
+  void SensorCamera::run_convertGroup(uint32_t index)
+  {
+    while (isPipelineRunning(index))
+    {
+      GroupPass *pass;
+      if (!m_groupRing[index].waitPop(pass, m_health[index].getFramePeriod()))
+      {
+        continue;
+      }
+
+      bool success = convertPass(index, *pass);
+      releasePass(pass, m_groupSize[index]);
+
+      if (!success)
+      {
+        break;
+      }
+    }
+  }
+
+  bool SensorCamera::convertPass(uint32_t index, const GroupPass &pass)
+  {
+    // the tensor needs every sibling, the images of the others are still published
+    const uint32_t siblings = m_groupSize[index];
+    bool complete = true;
+    for (uint32_t s = 0; s < siblings; ++s)
+    {
+      complete = complete && pass.frames[s];
+    }
+    if (complete && !convertTensor(index, pass.frames, pass.timestamp, pass.seq))
+    {
+      return false;
+    }
+
+    if (!m_config[index].rawOutput)
+    {
+      return true;
+    }
+
+    for (uint32_t s = 0; s < siblings; ++s)
+    {
+      if (pass.frames[s] && isConversionDue(index + s, pass.timestamp) &&
+          !convertFrame(index + s, {pass.frames[s], pass.timestamp, pass.seq}))
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  bool SensorCamera::convertTensor(uint32_t index, const dwCameraFrameHandle_t *frames, dwTime_t timestamp, uint32_t seq)
+  {
+    dwImageHandle_t images[MAX_CAMERAS];
+    for (uint32_t s = 0; s < m_groupSize[index]; ++s)
+    {
+      dwStatus status = dwSensorCamera_getImage(&images[s], DW_CAMERA_OUTPUT_NATIVE_PROCESSED, frames[s]);
+      if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("dwSensorCamera_getImage() failed. Error: %s", dwGetStatusName(status));
+        return false;
+      }
+    }
+
+    const PipelineClock::time_point start = PipelineClock::now();
+    bool success = m_tensor[index].convert(images, timestamp, seq);
+    m_stats[index].tensor.record(start);
+
+    return success;
+  }
+
+  bool SensorCamera::hasSubscribers(uint32_t index, uint32_t o)
+  {
+    CameraOutput &output = m_output[index][o];
+    if (!m_lazy)
+    {
+      return true;
+    }
+
+    // CUDA frames are presented to the EGLStream consumer, the descriptors are useless without it
+    if (m_config[index].outputDomain == OUTPUT_DOMAIN_CUDA)
+    {
+      return output.eglProducer.isConnected();
+    }
+
+    return hasImageSubscribers(index, o) || output.shmPub.getNumSubscribers() > 0;
+  }
+
+  bool SensorCamera::hasImageSubscribers(uint32_t index, uint32_t o)
+  {
+    if (!m_lazy || m_output[index][o].cameraPub.getNumSubscribers() > 0)
+    {
+      return true;
+    }
+
+    // the first output of a sibling also feeds the group message
+    return m_groupSize[index] > 1 && o == 0 &&
+           m_groupBatch[m_cameraMaster[index]].publisher.getNumSubscribers() > 0;
+  }
+
+  void SensorCamera::initCameraInfo(uint32_t index, uint32_t o)
+  {
+    CameraOutput &output = m_output[index][o];
+    const PinholeIntrinsics &intrinsics = m_rectifier[index].getIntrinsics();
+
+    // the crop shifts and the resize scales the intrinsics of the rectified frame
+    const double sx = static_cast<double>(output.width) / output.roi.width;
+    const double sy = static_cast<double>(output.height) / output.roi.height;
+    const double fx = intrinsics.focalX * sx;
+    const double fy = intrinsics.focalY * sy;
+    const double cx = (intrinsics.u0 - output.roi.x) * sx;
+    const double cy = (intrinsics.v0 - output.roi.y) * sy;
 
-namespace nv
-{
+    sensor_msgs::CameraInfo &info = output.cameraInfo;
+    info = sensor_msgs::CameraInfo();
+    info.header.frame_id = m_frameId[index];
+    info.width = output.width;
+    info.height = output.height;
+    info.distortion_model = "plumb_bob";
+    info.D.assign(5, 0.0);
+    info.K = {{fx, 0.0, cx, 0.0, fy, cy, 0.0, 0.0, 1.0}};
+    info.R = {{1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0}};
+    info.P = {{fx, 0.0, cx, 0.0, 0.0, fy, cy, 0.0, 0.0, 0.0, 1.0, 0.0}};
+  }
 
-  void SensorCamera::initialize(dwContextHandle_t context, dwSALHandle_t hal)
+  void SensorCamera::publishCameraInfo(uint32_t index, uint32_t o, dwTime_t timestamp, uint32_t seq)
   {
-    m_sdk = context;
-    m_hal = hal;
+    CameraOutput &output = m_output[index][o];
+    if (output.infoPub.getNumSubscribers() == 0)
+    {
+      return;
+    }
 
-    m_cameraRun = false;
+    // the same stamp as the image, so image_geometry consumers can pair them
+    sensor_msgs::CameraInfoPtr info(new sensor_msgs::CameraInfo(output.cameraInfo));
+    info->header.stamp = m_clock.toStamp(timestamp);
+    info->header.seq = seq;
+    output.infoPub.publish(info);
   }
 
-  bool SensorCamera::start(dwSensorParams paramsClient)
+  bool SensorCamera::convertFrame(uint32_t index, const CapturedFrame &captured)
   {
-    dwStatus status;
-    //------------------------------------------------------------------------------
-    // initializes cameras
-    // -----------------------------------------
+    // outputs without subscribers or beyond their rate are skipped, the frame still goes back to the driver right after
+    bool active[MAX_OUTPUTS];
+    bool any = false;
+    for (uint32_t o = 0; o < m_outputCount[index]; ++o)
+    {
+      active[o] = hasSubscribers(index, o);
+      if (!active[o])
+      {
+        m_output[index][o].counters.skipped++;
+      }
+      else if (!isOutputDue(index, o, captured.timestamp))
+      {
+        m_output[index][o].counters.decimated++;
+        active[o] = false;
+      }
+      any = any || active[o];
+    }
+    if (!any)
+    {
+      m_counters[index].idle++;
+      return true;
+    }
+
+    dwImageHandle_t img;
+    dwCameraOutputType outputType = DW_CAMERA_OUTPUT_NATIVE_PROCESSED;
+    dwStatus status = dwSensorCamera_getImage(&img, outputType, captured.frame);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("dwSensorCamera_getImage() failed. Error: %s", dwGetStatusName(status));
+      return false;
+    }
+
+    // all targets of an output in flight, wait for its receive stage to hand one back;
+    // a dropping output gives up after one frame period so the others keep up with the camera
+    for (uint32_t o = 0; o < m_outputCount[index]; ++o)
+    {
+      CameraOutput &output = m_output[index][o];
+      while (active[o] && output.streamFreeCount == 0)
+      {
+        dwImageHandle_t returned = DW_NULL_HANDLE;
+        status = dwImageStreamer_producerReturn(&returned, m_health[index].getFramePeriod(), output.streamer);
+        if (status == DW_SUCCESS)
+        {
+          output.streamFree[output.streamFreeCount++] = returned;
+        }
+        else if (status != DW_TIME_OUT)
+        {
+          ROS_ERROR("dwImageStreamer_producerReturn() failed. Error: %s", dwGetStatusName(status));
+          return false;
+        }
+        else if (!isPipelineRunning(index))
+        {
+          return false;
+        }
+        else if (output.backpressure.policy != BACKPRESSURE_BLOCK)
+        {
+          output.counters.convertDropped++;
+          active[o] = false;
+        }
+      }
+    }
+
+    // convert native (yuv420 nvmedia) to the output format once for all outputs
+    dwImageHandle_t source = img;
+    if (m_convertedFrame[index])
     {
-      status = dwSAL_createSensor(&m_camera[0], paramsClient, m_hal);
+      const PipelineClock::time_point start = PipelineClock::now();
+      status = dwImage_copyConvert(m_convertedFrame[index], img, m_sdk);
+      m_stats[index].convert.record(start);
       if (status != DW_SUCCESS)
       {
-        ROS_ERROR("Cannot create sensor %s with %s. Error: %s", paramsClient.protocol, paramsClient.parameters, dwGetStatusName(status));
+        ROS_ERROR("dwImage_copyConvert() failed. Error: %s", dwGetStatusName(status));
+        return false;
+      }
+      source = m_convertedFrame[index];
+    }
 
+    // undistort the full size frame once, the outputs crop and resize the rectified frame
+    if (m_rectifier[index].isEnabled())
+    {
+      const PipelineClock::time_point start = PipelineClock::now();
+      const bool rectified = m_rectifier[index].rectify(source, m_health[index].getFramePeriod());
+      m_stats[index].rectify.record(start);
+      if (!rectified)
+      {
         return false;
       }
+      source = m_rectifier[index].getImage();
     }
 
-    dwImageProperties imageProperties{};
-    status = dwSensorCamera_getImageProperties(&imageProperties, DW_CAMERA_OUTPUT_NATIVE_PROCESSED, m_camera[0]);
-    if (status != DW_SUCCESS)
+    // siblings of a group carry the stamp of the group capture
+    dwTime_t timestamp = captured.timestamp;
+    if (timestamp == 0)
+    {
+      dwImage_getTimestamp(&timestamp, img);
+    }
+
+    for (uint32_t o = 0; o < m_outputCount[index]; ++o)
     {
-      ROS_ERROR("Error");
+      CameraOutput &output = m_output[index][o];
+      if (!active[o])
+      {
+        continue;
+      }
 
-      dwSAL_releaseSensor(m_camera[0]);
+      // CUDA consumers release targets in any order, only a returned one is reused
+      dwImageHandle_t target = output.streamFree[--output.streamFreeCount];
 
-      return false;
+      const PipelineClock::time_point start = PipelineClock::now();
+      if (output.fusedScale > 0)
+      {
+        // convert and resize the native frame into the target in one pass
+        if (!convertFused(index, o, img, target))
+        {
+          return false;
+        }
+      }
+      else if (output.transform)
+      {
+        // crop and resize the frame into the target
+        const dwRect targetRect = {0, 0, static_cast<int32_t>(output.width), static_cast<int32_t>(output.height)};
+        status = dwImageTransformation_copy(target, source, &targetRect, &output.roi, m_imageTransformationEngine[index]);
+        if (status != DW_SUCCESS)
+        {
+          ROS_ERROR("dwImageTransformation_copy() failed. Error: %s", dwGetStatusName(status));
+          return false;
+        }
+      }
+      else
+      {
+        // the camera frame is returned right after, a plain copy if the source is in the output format
+        status = dwImage_copyConvert(target, source, m_sdk);
+        if (status != DW_SUCCESS)
+        {
+          ROS_ERROR("dwImage_copyConvert() failed. Error: %s", dwGetStatusName(status));
+          return false;
+        }
+      }
+      // straight from the native frame this was the conversion
+      if (output.fusedScale > 0 || (source == img && !output.transform))
+      {
+        m_stats[index].convert.record(start);
+      }
+      else
+      {
+        output.stats.transform.record(start);
+      }
+
+      dwImage_setTimestamp(timestamp, target);
+
+      // stream that image to the CPU or CUDA domain, the receive stage of the output picks it up
+      const int64_t sendTime = getPipelineTime();
+      output.sendTime[output.streamSent % output.streamTargets].store(sendTime, std::memory_order_relaxed);
+      output.sendSeq[output.streamSent % output.streamTargets].store(captured.seq, std::memory_order_relaxed);
+      status = dwImageStreamer_producerSend(target, output.streamer);
+      if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("dwImageStreamer_producerSend() failed. Error: %s", dwGetStatusName(status));
+        return false;
+      }
+      output.stats.send.record(getPipelineTime() - sendTime);
+      output.streamSent++;
     }
 
-    // create an image to hold the conversion from native to rgba, fit for streaming to gl
-    imageProperties.format = DW_IMAGE_FORMAT_RGBA_UINT8;
-    status = dwImage_create(&m_rgbaFrame[0], imageProperties, m_sdk);
+    m_counters[index].converted++;
+
+    return true;
+  }
+
+  bool SensorCamera::convertFused(uint32_t index, uint32_t o, dwImageHandle_t source, dwImageHandle_t target)
+  {
+    CameraOutput &output = m_output[index][o];
+    dwImageCUDA *sourceCUDA = nullptr;
+    dwImageCUDA *targetCUDA = nullptr;
+    dwStatus status = dwImage_getCUDA(&sourceCUDA, source);
+    if (status == DW_SUCCESS)
+    {
+      status = dwImage_getCUDA(&targetCUDA, target);
+    }
     if (status != DW_SUCCESS)
     {
-      ROS_ERROR("Error");
+      ROS_ERROR("dwImage_getCUDA() failed. Error: %s", dwGetStatusName(status));
+      return false;
+    }
 
-      dwSAL_releaseSensor(m_camera[0]);
+    FrameConversion conversion{};
+    for (uint32_t p = 0; p < 3; ++p)
+    {
+      conversion.plane[p] = static_cast<const uint8_t *>(sourceCUDA->dptr[p]);
+      conversion.pitch[p] = static_cast<uint32_t>(sourceCUDA->pitch[p]);
+    }
+    conversion.format = output.fusedFormat;
+    conversion.sourceWidth = sourceCUDA->prop.width;
+    conversion.sourceHeight = sourceCUDA->prop.height;
+    conversion.output = static_cast<uint8_t *>(targetCUDA->dptr[0]);
+    conversion.outputPitch = static_cast<uint32_t>(targetCUDA->pitch[0]);
+    conversion.channels = targetCUDA->prop.format == DW_IMAGE_FORMAT_RGB_UINT8 ? 3 : 4;
+    conversion.width = output.width;
+    conversion.height = output.height;
 
+    // the default stream, as dwImageTransformation and the streamer, orders the send after the kernel
+    cudaError_t error = launchFrameConversion(conversion, nullptr);
+    if (error != cudaSuccess)
+    {
+      ROS_ERROR("Fused conversion of camera %u output /%s failed. Error: %s", index, output.topic.c_str(),
+                cudaGetErrorString(error));
       return false;
     }
 
-    // initialize the image transformation and the resized image
-    if (m_shrinkFactor > 1.0f)
+    return true;
+  }
+
+  void SensorCamera::run_receive(uint32_t index, uint32_t o)
+  {
+    CameraOutput &output = m_output[index][o];
+    while (isPipelineRunning(index))
     {
-      dwImageTransformationParameters m_params{false};
-      m_params.ignoreAspectRatio = false;
+      // frames the EGLStream consumer released since, at least once per frame period
+      if (m_config[index].outputDomain == OUTPUT_DOMAIN_CUDA)
+      {
+        reclaimCudaFrames(index, o);
+      }
 
-      dwImageTransformation_initialize(&m_imageTransformationEngine, m_params, m_sdk);
-      dwImageTransformation_setBorderMode(DW_IMAGEPROCESSING_BORDER_MODE_ZERO, m_imageTransformationEngine);
-      dwImageTransformation_setInterpolationMode(DW_IMAGEPROCESSING_INTERPOLATION_DEFAULT, m_imageTransformationEngine);
+      // receive the streamed image as a handle
+      dwImageHandle_t cpuFrame;
+      dwStatus status = dwImageStreamer_consumerReceive(&cpuFrame, m_health[index].getFramePeriod(), output.streamer);
+      if (status == DW_TIME_OUT)
+      {
+        continue;
+      }
+      else if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("dwImageStreamer_consumerReceive() failed. Error: %s", dwGetStatusName(status));
+        break;
+      }
+      const uint32_t slot = output.streamReceived % output.streamTargets;
+      output.stats.stream.record(getPipelineTime() - output.sendTime[slot].load(std::memory_order_relaxed));
+      const uint32_t seq = output.sendSeq[slot].load(std::memory_order_relaxed);
+      output.streamReceived++;
 
-      imageProperties.width /= m_shrinkFactor;
-      imageProperties.height /= m_shrinkFactor;
-      imageProperties.format = DW_IMAGE_FORMAT_RGBA_UINT8;
+      // CUDA frames are returned to the streamer once the EGLStream consumer released them
+      if (m_config[index].outputDomain == OUTPUT_DOMAIN_CUDA)
+      {
+        if (!receiveCudaFrame(index, o, cpuFrame, seq))
+        {
+          break;
+        }
+        continue;
+      }
 
-      ROS_INFO("Small image size %d %d", imageProperties.width, imageProperties.height);
-      CHECK_DW_ERROR(dwImage_create(&m_imageResized, imageProperties, m_sdk));
-    }
+      bool success = receiveFrame(index, o, cpuFrame, seq);
 
-    // setup streamer for frame grabbing
-    status = dwImageStreamer_initialize(&m_streamerNvmediaToCpuProcessed[0], &imageProperties, DW_IMAGE_CPU, m_sdk);
-    if (status != DW_SUCCESS)
-    {
-      ROS_ERROR("Error");
-      if (m_imageResized)
+      // hands the target back to the convert stage
+      dwImageStreamer_consumerReturn(&cpuFrame, output.streamer);
+
+      if (!success)
       {
-        dwImage_destroy(m_imageResized);
+        break;
       }
+    }
+  }
 
-      dwImage_destroy(m_rgbaFrame[0]);
-      dwSAL_releaseSensor(m_camera[0]);
+  bool SensorCamera::receiveFrame(uint32_t index, uint32_t o, dwImageHandle_t cpuFrame, uint32_t seq)
+  {
+    CameraOutput &output = m_output[index][o];
 
+    dwImageProperties prop;
+    dwStatus status = dwImage_getProperties(&prop, cpuFrame);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("dwImage_getProperties() failed. Error: %s", dwGetStatusName(status));
       return false;
     }
 
-    // start camera
-    status = dwSensor_start(m_camera[0]);
+    dwImageCPU *imgCPU;
+    status = dwImage_getCPU(&imgCPU, cpuFrame);
     if (status != DW_SUCCESS)
     {
-      ROS_ERROR("Cannot start camera. Error: %s", dwGetStatusName(status));
+      ROS_ERROR("dwImage_getCPU() failed. Error: %s", dwGetStatusName(status));
+      return false;
+    }
 
-      dwSAL_releaseSensor(m_camera[0]);
+    output.counters.received++;
 
-      return false;
+    dwTime_t timestamp;
+    dwImage_getTimestamp(&timestamp, cpuFrame);
+    publishCameraInfo(index, o, timestamp, seq);
+
+    if (output.shmPub.getNumSubscribers() > 0)
+    {
+      publishShm(index, o, imgCPU, prop, timestamp, seq);
     }
 
-    m_cameraThread = std::thread(&SensorCamera::run_camera, this);
-    m_cameraRun = true;
+    // the raw topic is skipped if only the shm transport is subscribed
+    if (!hasImageSubscribers(index, o))
+    {
+      return true;
+    }
+
+    const OutputEncoding encoding = m_config[index].outputEncoding;
+    if (m_zeroCopy && isViewable(encoding))
+    {
+      // the payload lives in the streamer buffer, so it is serialized on this stage before the buffer is returned
+      ImageView view;
+      view.header.stamp = m_clock.toStamp(timestamp);
+      view.header.seq = seq;
+      view.header.frame_id = m_frameId[index];
+      view.height = prop.height;
+      view.width = prop.width;
+      view.encoding = getEncodingName(encoding);
+      view.step = imgCPU->pitch[0];
+      view.data = imgCPU->data[0];
+
+      const PipelineClock::time_point start = PipelineClock::now();
+      output.cameraPub.publish(view);
+      output.stats.publish.record(start);
+      recordLatency(index, o, timestamp);
+      output.counters.published++;
+
+      return true;
+    }
+
+    // a full ring is resolved before the copy, so a frame which is not queued costs nothing
+    if (!waitPublishRing(index, o))
+    {
+      return true;
+    }
+
+    // recycled message with a pre-sized buffer, all of them still in flight means a slow transport
+    ImagePtr image = output.imagePool.acquire();
+    if (!image)
+    {
+      ROS_WARN_THROTTLE(1.0, "camera %u output /%s all %d pooled messages in flight, dropping frame", index,
+                        output.topic.c_str(), m_poolDepth);
+      output.counters.receiveDropped++;
+
+      return true;
+    }
+
+    image->header.stamp = m_clock.toStamp(timestamp);
+    ROS_DEBUG("timestamp:  %u.%u", image->header.stamp.sec, image->header.stamp.nsec);
+
+    // the sensor frame number, siblings of a group capture share it
+    image->header.seq = seq;
+
+    const PipelineClock::time_point start = PipelineClock::now();
+    copyFrame(image->data.data(), imgCPU, encoding, prop.width, prop.height);
+    output.stats.copy.record(start);
+
+    // the pool keeps the message reserved until the publish stage recycles it, drop-oldest evicts here
+    Image *evicted;
+    if (output.publishRing.push(image.get(), evicted))
+    {
+      output.imagePool.recycle(evicted);
+    }
 
     return true;
   }
 
-  bool SensorCamera::stop()
+  bool SensorCamera::waitPublishRing(uint32_t index, uint32_t o)
   {
-    if (!m_cameraRun)
+    CameraOutput &output = m_output[index][o];
+    switch (output.backpressure.policy)
     {
-      ROS_WARN("CAMERA sensor not running");
-      return false;
+    case BACKPRESSURE_DROP_NEWEST:
+      if (output.publishRing.isFull())
+      {
+        output.counters.ringRejected++;
+        return false;
+      }
+      break;
+
+    case BACKPRESSURE_BLOCK:
+    {
+      // the streamer holds the frame meanwhile, so the wait backs up into the convert stage
+      const int64_t deadline = output.backpressure.deadlineMs > 0
+                                   ? static_cast<int64_t>(output.backpressure.deadlineMs) * 1000
+                                   : m_health[index].getFramePeriod();
+      if (!output.publishRing.waitSpace(deadline))
+      {
+        output.counters.deadlineMissed++;
+        return false;
+      }
+      break;
     }
 
-    m_cameraRun = false;
+    default:
+      break;
+    }
 
-    if (m_cameraThread.joinable())
-      m_cameraThread.join();
+    return true;
+  }
 
-    if (m_streamerNvmediaToCpuProcessed[0])
-    {
-      dwImageStreamer_release(m_streamerNvmediaToCpuProcessed[0]);
-    }
+  void SensorCamera::publishShm(uint32_t index, uint32_t o, const dwImageCPU *imgCPU, const dwImageProperties &prop,
+                                dwTime_t timestamp, uint32_t seq)
+  {
+    CameraOutput &output = m_output[index][o];
+    const OutputEncoding encoding = m_config[index].outputEncoding;
 
-    if (m_rgbaFrame[0])
+    // one copy into shared memory however many subscribers there are
+    uint32_t slot;
+    uint8_t *data = output.shmRing.acquire(slot);
+    if (!data)
     {
-      dwImage_destroy(m_rgbaFrame[0]);
+      ROS_WARN_THROTTLE(1.0, "camera %u output /%s every shared-memory slot is held by a subscriber, dropping frame",
+                        index, output.topic.c_str());
+      return;
     }
 
-    if (m_imageResized)
+    const PipelineClock::time_point start = PipelineClock::now();
+    copyFrame(data, imgCPU, encoding, prop.width, prop.height);
+    output.stats.copy.record(start);
+    const size_t size = getFrameSize(encoding, prop.width, prop.height);
+
+    nv_sensors::ShmImagePtr descriptor(new nv_sensors::ShmImage);
+    descriptor->header.stamp = m_clock.toStamp(timestamp);
+    descriptor->header.seq = seq;
+    descriptor->header.frame_id = m_frameId[index];
+    descriptor->height = prop.height;
+    descriptor->width = prop.width;
+    descriptor->encoding = getEncodingName(encoding);
+    descriptor->is_bigendian = 0;
+    descriptor->step = getPixelSize(encoding) * prop.width;
+    descriptor->segment = output.shmRing.getName();
+    descriptor->slot = slot;
+    descriptor->generation = output.shmRing.commit(slot, size);
+    descriptor->size = static_cast<uint32_t>(size);
+    output.shmPub.publish(descriptor);
+    output.counters.shmPublished++;
+  }
+
+  bool SensorCamera::receiveCudaFrame(uint32_t index, uint32_t o, dwImageHandle_t cudaFrame, uint32_t seq)
+  {
+    CameraOutput &output = m_output[index][o];
+
+    dwImageCUDA *imgCUDA;
+    dwStatus status = dwImage_getCUDA(&imgCUDA, cudaFrame);
+    if (status != DW_SUCCESS)
     {
-      dwImage_destroy(m_imageResized);
+      ROS_ERROR("dwImage_getCUDA() failed. Error: %s", dwGetStatusName(status));
+      dwImageStreamer_consumerReturn(&cudaFrame, output.streamer);
+      return false;
     }
 
-    if (m_camera[0])
+    output.counters.received++;
+
+    if (!output.eglProducer.present(imgCUDA->dptr[0], imgCUDA->pitch[0]))
     {
-      dwSAL_releaseSensor(m_camera[0]);
+      // no consumer, the frame goes straight back
+      dwImageStreamer_consumerReturn(&cudaFrame, output.streamer);
+      return true;
     }
+    output.cudaPending[output.cudaPendingCount++] = cudaFrame;
+
+    // the frame it replaced in the mailbox is free again right away
+    reclaimCudaFrames(index, o);
+
+    dwTime_t timestamp;
+    dwImage_getTimestamp(&timestamp, cudaFrame);
+    publishCameraInfo(index, o, timestamp, seq);
+
+    nv_sensors::CudaFramePtr descriptor(new nv_sensors::CudaFrame);
+    descriptor->header.stamp = m_clock.toStamp(timestamp);
+    descriptor->header.seq = seq;
+    descriptor->header.frame_id = m_frameId[index];
+    descriptor->height = imgCUDA->prop.height;
+    descriptor->width = imgCUDA->prop.width;
+    descriptor->encoding = sensor_msgs::image_encodings::RGBA8;
+    descriptor->step = imgCUDA->pitch[0];
+    descriptor->socket_path = output.eglProducer.getSocketPath();
+    const PipelineClock::time_point start = PipelineClock::now();
+    output.cudaPub.publish(descriptor);
+    output.stats.publish.record(start);
+    recordLatency(index, o, timestamp);
+    output.counters.published++;
 
     return true;
   }
 
-  void SensorCamera::run_camera()
+  void SensorCamera::reclaimCudaFrames(uint32_t index, uint32_t o)
   {
-    while (m_cameraRun)
+    CameraOutput &output = m_output[index][o];
+    if (output.cudaPendingCount == 0)
     {
-      dwCameraFrameHandle_t frame;
-      dwStatus status = dwSensorCamera_readFrameNew(&frame, 33333, m_camera[0]);
-      if (status == DW_END_OF_STREAM)
+      return;
+    }
+
+    // a consumer which went away releases everything it held
+    if (!output.eglProducer.isConnected())
+    {
+      for (uint32_t k = 0; k < output.cudaPendingCount; ++k)
       {
-        ROS_WARN("camera sensor end of stream reached.");
-        break;
+        dwImageStreamer_consumerReturn(&output.cudaPending[k], output.streamer);
       }
-      else if (status == DW_TIME_OUT)
+      output.cudaPendingCount = 0;
+      return;
+    }
+
+    void *dptr;
+    while ((dptr = output.eglProducer.reclaim()) != nullptr)
+    {
+      for (uint32_t k = 0; k < output.cudaPendingCount; ++k)
       {
-        ROS_WARN("camera sensor readFrame timed-out.");
-        continue;
+        dwImageCUDA *imgCUDA;
+        if (dwImage_getCUDA(&imgCUDA, output.cudaPending[k]) == DW_SUCCESS && imgCUDA->dptr[0] == dptr)
+        {
+          dwImageStreamer_consumerReturn(&output.cudaPending[k], output.streamer);
+          output.cudaPending[k] = output.cudaPending[--output.cudaPendingCount];
+          break;
+        }
       }
-      else if (status == DW_NOT_READY)
+    }
+  }
+
+  void SensorCamera::run_publish(uint32_t index, uint32_t o)
+  {
+    CameraOutput &output = m_output[index][o];
+    while (isPipelineRunning(index))
+    {
+      Image *queued;
+      if (!output.publishRing.waitPop(queued, m_health[index].getFramePeriod()))
       {
-        ROS_WARN("camera sensor not ready.");
         continue;
       }
 
-      if (status != DW_SUCCESS)
+      ImagePtr image = output.imagePool.share(queued);
+      const PipelineClock::time_point start = PipelineClock::now();
+      output.cameraPub.publish(image);
+      output.stats.publish.record(start);
+      recordLatency(index, o, m_clock.toSensorTime(image->header.stamp));
+      if (m_groupSize[index] > 1 && o == 0)
       {
-        ROS_ERROR("camera sensor readFrame failed. Error: %s", dwGetStatusName(status));
-        break;
+        offerGroupImage(index, image);
       }
-      else
-      {
-        ROS_INFO("camera sensor readFrame success.");
+      output.imagePool.recycle(queued);
 
-        dwImageHandle_t img;
-        dwCameraOutputType outputType = DW_CAMERA_OUTPUT_NATIVE_PROCESSED;
-        status = dwSensorCamera_getImage(&img, outputType, frame);
-        if (status != DW_SUCCESS)
-        {
-          ROS_ERROR("Error");
-          break;
-        }
+      output.counters.published++;
+    }
+  }
 
-        // convert native (yuv420 planar nvmedia) to rgba nvmedia
-        status = dwImage_copyConvert(m_rgbaFrame[0], img, m_sdk);
-        if (status != DW_SUCCESS)
-        {
-          ROS_ERROR("Error");
-          break;
-        }
+  void SensorCamera::offerGroupImage(uint32_t index, const sensor_msgs::ImageConstPtr &image)
+  {
+    GroupBatch &batch = m_groupBatch[m_cameraMaster[index]];
+    if (batch.publisher.getNumSubscribers() == 0)
+    {
+      return;
+    }
+
+    const uint32_t siblings = m_groupSize[index];
+    sensor_msgs::ImageConstPtr images[MAX_CAMERAS];
+    {
+      std::lock_guard<std::mutex> lock(batch.mutex);
 
-        dwImageHandle_t cpuFrame;
-        if (m_shrinkFactor > 1.0f)
+      // siblings of one capture share the frame number, a newer capture drops an incomplete batch and a late
+      // image of a dropped batch is ignored
+      const int32_t age = static_cast<int32_t>(image->header.seq - batch.seq);
+      if (age != 0)
+      {
+        if (age < 0)
         {
-          // resize image and send it to the streamer
-          dwImageTransformation_copyFullImage(m_imageResized, m_rgbaFrame[0], m_imageTransformationEngine);
-          if (status != DW_SUCCESS)
-          {
-            ROS_ERROR("Error image transform");
-            break;
-          }
-          // stream that image to the CPU domain
-          CHECK_DW_ERROR(dwImageStreamer_producerSend(m_imageResized, m_streamerNvmediaToCpuProcessed[0]));
-
-          // receive the streamed image as a handle
-          status = dwImageStreamer_consumerReceive(&cpuFrame, 33000, m_streamerNvmediaToCpuProcessed[0]);
-          if (status != DW_SUCCESS)
-          {
-            ROS_ERROR("Error");
-            break;
-          }
+          return;
         }
-        else
+        for (uint32_t s = 0; s < siblings; ++s)
         {
-          // just send the m_rgbaFrame to the streamer
-
-          // stream that image to the CPU domain
-          status = dwImageStreamer_producerSend(m_rgbaFrame[0], m_streamerNvmediaToCpuProcessed[0]);
-          if (status != DW_SUCCESS)
-          {
-            ROS_ERROR("Error");
-            break;
-          }
-
-          // receive the streamed image as a handle
-          status = dwImageStreamer_consumerReceive(&cpuFrame, 33000, m_streamerNvmediaToCpuProcessed[0]);
-          if (status != DW_SUCCESS)
-          {
-            ROS_ERROR("Error");
-            break;
-          }
+          batch.images[s].reset();
         }
+        batch.count = 0;
+        batch.seq = image->header.seq;
+      }
 
-        dwImageProperties prop;
-        status = dwImage_getProperties(&prop, cpuFrame);
-        if (status != DW_SUCCESS)
-        {
-          ROS_ERROR("dwImage_getProperties() failed. Error: %s", dwGetStatusName(status));
-          break;
-        }
+      if (!batch.images[m_sibling[index]])
+      {
+        batch.images[m_sibling[index]] = image;
+        batch.count++;
+      }
 
-        dwImageCPU *imgCPU;
-        status = dwImage_getCPU(&imgCPU, cpuFrame);
-        if (status != DW_SUCCESS)
-        {
-          ROS_ERROR("dwImage_getCPU() failed. Error: %s", dwGetStatusName(status));
-          break;
-        }
+      if (batch.count < siblings)
+      {
+        return;
+      }
 
-        unsigned int pair_id = 0;
-        ImagePtr image(new Image);
+      // the pooled images are held until the batch is serialized
+      for (uint32_t s = 0; s < siblings; ++s)
+      {
+        images[s].swap(batch.images[s]);
+      }
+      batch.count = 0;
+    }
+
+    // serialized from the pooled images, without copying them into a message
+    CameraGroupView group;
+    group.header.stamp = images[0]->header.stamp;
+    group.header.seq = images[0]->header.seq;
+    group.header.frame_id = batch.topic;
+    group.images = images;
+    group.count = siblings;
+    batch.publisher.publish(group);
+  }
+
+  void SensorCamera::recordLatency(uint32_t index, uint32_t o, dwTime_t timestamp)
+  {
+    // sensor timestamps are in the time base of the Driveworks context
+    dwTime_t now;
+    if (dwContext_getCurrentTime(&now, m_sdk) == DW_SUCCESS)
+    {
+      m_output[index][o].stats.latency.record(now - timestamp);
+    }
+  }
 
-        dwTime_t timestamp;
-        dwImage_getTimestamp(&timestamp, img);
-        image->header.stamp.sec = (timestamp / 1000000L);
-        image->header.stamp.nsec = (timestamp % 1000000L) * 1000;
-        ROS_DEBUG("timestamp:  %u.%u", image->header.stamp.sec, image->header.stamp.nsec);
+  void SensorCamera::collectStats(diagnostic_msgs::DiagnosticArray &diagnostics)
+  {
+    const PipelineClock::time_point now = PipelineClock::now();
+    const double elapsed = std::chrono::duration<double>(now - m_statsTime).count();
+    m_statsTime = now;
 
-        image->header.seq = pair_id;
-        pair_id++;
+    diagnostics.header.stamp = ros::Time::now();
+    diagnostics.status.clear();
+    if (elapsed <= 0.0)
+    {
+      return;
+    }
 
-        image->header.frame_id = "camera";
+    for (uint32_t i = 0; i < m_cameraCount; ++i)
+    {
+      diagnostic_msgs::DiagnosticStatus camera;
+      const uint64_t captured = m_counters[i].captured.load();
+      const double captureRate = (captured - m_statsCaptured[i]) / elapsed;
+      m_statsCaptured[i] = captured;
 
-        fillImage(*image, sensor_msgs::image_encodings::RGBA8, prop.height, prop.width, 4 * prop.width, imgCPU->data[0]);
+      camera.name = "nv_sensors: camera " + std::to_string(i);
+      camera.hardware_id = m_frameId[i];
+      const CaptureHealth::State health = m_health[i].getState();
+      camera.level = health == CaptureHealth::STALLED ? diagnostic_msgs::DiagnosticStatus::ERROR
+                     : captureRate > 0.0              ? diagnostic_msgs::DiagnosticStatus::OK
+                                                      : diagnostic_msgs::DiagnosticStatus::WARN;
+      camera.message = formatRate(captureRate) + " fps captured, " + m_health[i].getStateName();
+      addValue(camera, "health", m_health[i].getStateName());
+      addValue(camera, "missed reads", std::to_string(m_health[i].getMissed()));
+      addValue(camera, "sensor dropped", std::to_string(m_counters[i].sensorDropped.load()));
+      addValue(camera, "capture fps", formatRate(captureRate));
+      addValue(camera, "captured", std::to_string(captured));
+      addValue(camera, "capture ring dropped", std::to_string(m_captureRing[i].getDropped()));
+      addValue(camera, "converted", std::to_string(m_counters[i].converted.load()));
+      addValue(camera, "no subscriber", std::to_string(m_counters[i].idle.load()));
+      addStage(camera, "read", m_stats[i].read);
+      addStage(camera, "encode", m_stats[i].encode);
+      addStage(camera, "convert", m_stats[i].convert);
+      if (m_rectifier[i].isEnabled())
+      {
+        addStage(camera, "rectify", m_stats[i].rectify);
+      }
+      if (m_recorder[i].isRecording())
+      {
+        addValue(camera, "recorded frames", std::to_string(m_recorder[i].getFrames()));
+        addValue(camera, "recorded MB", std::to_string(m_recorder[i].getBytes() >> 20));
+        addValue(camera, "record dropped", std::to_string(m_recorder[i].getDropped()));
+      }
+      if (m_tensor[i].isEnabled())
+      {
+        addValue(camera, "tensor no free message", std::to_string(m_tensor[i].getDropped()));
+        addStage(camera, "tensor", m_stats[i].tensor);
+      }
+      diagnostics.status.push_back(camera);
 
-        dwImageStreamer_consumerReturn(&cpuFrame, m_streamerNvmediaToCpuProcessed[0]);
-        dwImageStreamer_producerReturn(nullptr, 33000, m_streamerNvmediaToCpuProcessed[0]);
+      for (uint32_t o = 0; o < m_outputCount[i]; ++o)
+      {
+        CameraOutput &output = m_output[i][o];
+        diagnostic_msgs::DiagnosticStatus status;
+        const uint64_t published = output.counters.published.load();
+        const double publishRate = (published - output.statsPublished) / elapsed;
+        output.statsPublished = published;
 
-        dwSensorCamera_returnFrame(&frame);
+        status.name = "nv_sensors: /" + output.topic;
+        status.hardware_id = m_frameId[i];
+        // an output nobody listens to is idle, not late
+        const bool idle = !hasSubscribers(i, o);
+        status.level = publishRate > 0.0 || !m_config[i].rawOutput || idle ? diagnostic_msgs::DiagnosticStatus::OK
+                                                                            : diagnostic_msgs::DiagnosticStatus::WARN;
+        status.message = idle ? std::string("no subscriber") : formatRate(publishRate) + " fps published";
+        addValue(status, "publish fps", formatRate(publishRate));
+        addValue(status, "no subscriber", std::to_string(output.counters.skipped.load()));
+        addValue(status, "decimated", std::to_string(output.counters.decimated.load()));
+        addValue(status, "backpressure", getBackpressureName(output.backpressure.policy));
+        addValue(status, "convert dropped", std::to_string(output.counters.convertDropped.load()));
+        addValue(status, "received", std::to_string(output.counters.received.load()));
+        addValue(status, "no free message", std::to_string(output.counters.receiveDropped.load()));
+        addValue(status, "publish ring dropped", std::to_string(output.publishRing.getDropped()));
+        addValue(status, "publish ring rejected", std::to_string(output.counters.ringRejected.load()));
+        addValue(status, "publish deadline missed", std::to_string(output.counters.deadlineMissed.load()));
 
-        m_cameraPub.publish(image);
+        // drops of this output by the stage which dropped them
+        addValue(status, "dropped driver", std::to_string(m_counters[i].sensorDropped.load()));
+        addValue(status, "dropped convert",
+                 std::to_string(m_captureRing[i].getDropped() + output.counters.convertDropped.load()));
+        addValue(status, "dropped ring",
+                 std::to_string(output.publishRing.getDropped() + output.counters.ringRejected.load() +
+                                output.counters.deadlineMissed.load()));
+        addValue(status, "dropped transport", std::to_string(output.counters.receiveDropped.load()));
+        addValue(status, "published", std::to_string(published));
+        if (output.shmRing.isOpen())
+        {
+          addValue(status, "shm published", std::to_string(output.counters.shmPublished.load()));
+          addValue(status, "shm no free slot", std::to_string(output.shmRing.getDropped()));
+        }
+        addStage(status, "transform", output.stats.transform);
+        addStage(status, "send", output.stats.send);
+        addStage(status, "stream", output.stats.stream);
+        addStage(status, "copy", output.stats.copy);
+        addStage(status, "publish", output.stats.publish);
+        addStage(status, "latency", output.stats.latency);
+        diagnostics.status.push_back(status);
       }
     }
+
+    diagnostic_msgs::DiagnosticStatus clock;
+    clock.name = "nv_sensors: clock";
+    clock.level = diagnostic_msgs::DiagnosticStatus::OK;
+    clock.message = std::string(m_clock.getDomainName()) + " time";
+    addValue(clock, "domain", m_clock.getDomainName());
+    addValue(clock, "offset us", std::to_string(m_clock.getOffset()));
+    addValue(clock, "jitter us", std::to_string(m_clock.getJitter()));
+    diagnostics.status.push_back(clock);
   }
 
 } // namespace nv
@@ -0,0 +1,573 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "camera_config.h"
+
+#include <ros/ros.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace nv
+{
+
+  // positive decimal option value
+  static bool parseCount(const std::string &key, const std::string &value, uint32_t &count, bool &valid)
+  {
+    char *end = nullptr;
+    unsigned long parsed = strtoul(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || parsed == 0 || parsed > UINT32_MAX)
+    {
+      ROS_ERROR("Invalid %s %s, expected a positive number", key.c_str(), value.c_str());
+      valid = false;
+      return true;
+    }
+
+    count = static_cast<uint32_t>(parsed);
+    return true;
+  }
+
+  static bool parseFlag(const std::string &key, const std::string &value, bool &flag, bool &valid)
+  {
+    if (value == "true" || value == "1")
+    {
+      flag = true;
+    }
+    else if (value == "false" || value == "0")
+    {
+      flag = false;
+    }
+    else
+    {
+      ROS_ERROR("Invalid %s %s, expected true or false", key.c_str(), value.c_str());
+      valid = false;
+    }
+    return true;
+  }
+
+  // <r>:<g>:<b> per channel values, a single value applies to all channels
+  static bool parseChannels(const std::string &key, const std::string &value, float channels[3], bool positive, bool &valid)
+  {
+    float parsed[3];
+    char tail;
+    int count = sscanf(value.c_str(), "%f:%f:%f%c", &parsed[0], &parsed[1], &parsed[2], &tail);
+    if (count == 1)
+    {
+      parsed[1] = parsed[0];
+      parsed[2] = parsed[0];
+    }
+    else if (count != 3)
+    {
+      ROS_ERROR("Invalid %s %s, expected <r>:<g>:<b>", key.c_str(), value.c_str());
+      valid = false;
+      return true;
+    }
+
+    for (uint32_t c = 0; c < 3; ++c)
+    {
+      if (positive && !(parsed[c] > 0.0f))
+      {
+        ROS_ERROR("Invalid %s %s, expected positive values", key.c_str(), value.c_str());
+        valid = false;
+        return true;
+      }
+      channels[c] = parsed[c];
+    }
+    return true;
+  }
+
+  // output=<name>[:<width>x<height>[:<crop width>x<crop height>+<x>+<y>]][@<Hz>|/<N>]
+  static bool parseOutput(const std::string &option, CameraConfig &config, bool &valid)
+  {
+    OutputConfig output;
+    bool parsed = true;
+
+    // the rate limit trails the geometry
+    std::string value = option;
+    size_t limit = value.find_first_of("@/");
+    if (limit != std::string::npos)
+    {
+      const std::string rate = value.substr(limit + 1);
+      char *end = nullptr;
+      if (value[limit] == '@')
+      {
+        output.rate = strtof(rate.c_str(), &end);
+        parsed = !rate.empty() && *end == '\0' && output.rate > 0.0f;
+      }
+      else
+      {
+        unsigned long decimation = strtoul(rate.c_str(), &end, 10);
+        parsed = !rate.empty() && *end == '\0' && decimation > 0 && decimation <= UINT32_MAX;
+        output.decimation = static_cast<uint32_t>(decimation);
+      }
+      value = value.substr(0, limit);
+    }
+
+    size_t size = value.find(':');
+    output.name = value.substr(0, size);
+
+    parsed = parsed && !output.name.empty();
+    if (parsed && size != std::string::npos)
+    {
+      size_t crop = value.find(':', size + 1);
+      std::string dimensions = value.substr(size + 1, crop == std::string::npos ? std::string::npos : crop - size - 1);
+      char tail;
+      parsed = sscanf(dimensions.c_str(), "%ux%u%c", &output.width, &output.height, &tail) == 2 &&
+               output.width > 0 && output.height > 0;
+
+      if (parsed && crop != std::string::npos)
+      {
+        parsed = sscanf(value.c_str() + crop + 1, "%ux%u+%u+%u%c", &output.cropWidth, &output.cropHeight,
+                        &output.cropX, &output.cropY, &tail) == 4 &&
+                 output.cropWidth > 0 && output.cropHeight > 0;
+      }
+    }
+
+    if (!parsed)
+    {
+      ROS_ERROR("Invalid output %s, expected <name>[:<width>x<height>[:<crop width>x<crop height>+<x>+<y>]][@<Hz>|/<N>]",
+                option.c_str());
+      valid = false;
+      return true;
+    }
+
+    for (const OutputConfig &other : config.outputs)
+    {
+      if (other.name == output.name)
+      {
+        ROS_ERROR("Duplicate output %s", output.name.c_str());
+        valid = false;
+        return true;
+      }
+    }
+
+    if (config.outputs.size() >= MAX_CAMERA_OUTPUTS)
+    {
+      ROS_ERROR("Cannot add output %s, at most %u outputs are supported", output.name.c_str(), MAX_CAMERA_OUTPUTS);
+      valid = false;
+      return true;
+    }
+
+    config.outputs.push_back(output);
+    return true;
+  }
+
+  static bool parseBackpressurePolicy(const std::string &name, BackpressurePolicy &policy)
+  {
+    if (name == "drop-oldest")
+    {
+      policy = BACKPRESSURE_DROP_OLDEST;
+    }
+    else if (name == "drop-newest")
+    {
+      policy = BACKPRESSURE_DROP_NEWEST;
+    }
+    else if (name == "block")
+    {
+      policy = BACKPRESSURE_BLOCK;
+    }
+    else
+    {
+      return false;
+    }
+
+    return true;
+  }
+
+  // backpressure=[<output>:]drop-oldest|drop-newest|block[:<ms>]
+  static bool parseBackpressure(const std::string &option, CameraConfig &config, bool &valid)
+  {
+    BackpressureConfig backpressure;
+
+    std::vector<std::string> fields;
+    size_t begin = 0;
+    while (begin <= option.size())
+    {
+      size_t end = option.find(':', begin);
+      end = end == std::string::npos ? option.size() : end;
+      fields.push_back(option.substr(begin, end - begin));
+      begin = end + 1;
+    }
+
+    // a leading policy name applies to all outputs
+    size_t policy = 0;
+    if (!parseBackpressurePolicy(fields[0], backpressure.policy))
+    {
+      backpressure.output = fields[0];
+      policy = 1;
+    }
+
+    bool parsed = !fields[0].empty() && policy < fields.size() && fields.size() <= policy + 2 &&
+                  parseBackpressurePolicy(fields[policy], backpressure.policy);
+
+    // only block waits
+    if (parsed && fields.size() == policy + 2)
+    {
+      const std::string &deadline = fields[policy + 1];
+      char *end = nullptr;
+      unsigned long ms = strtoul(deadline.c_str(), &end, 10);
+      parsed = backpressure.policy == BACKPRESSURE_BLOCK && !deadline.empty() && *end == '\0' && ms > 0 &&
+               ms <= UINT32_MAX;
+      backpressure.deadlineMs = static_cast<uint32_t>(ms);
+    }
+
+    if (!parsed)
+    {
+      ROS_ERROR("Invalid backpressure %s, expected [<output>:]drop-oldest|drop-newest|block[:<ms>]", option.c_str());
+      valid = false;
+      return true;
+    }
+
+    config.backpressure.push_back(backpressure);
+    return true;
+  }
+
+  // applies one option, returns false for keys which belong to Driveworks
+  static bool applyOption(const std::string &key, const std::string &value, CameraConfig &config, bool &valid)
+  {
+    if (key == "output-domain")
+    {
+      if (value == "cpu")
+      {
+        config.outputDomain = OUTPUT_DOMAIN_CPU;
+      }
+      else if (value == "cuda")
+      {
+        config.outputDomain = OUTPUT_DOMAIN_CUDA;
+      }
+      else
+      {
+        ROS_ERROR("Invalid output-domain %s, expected cpu or cuda", value.c_str());
+        valid = false;
+      }
+      return true;
+    }
+
+    if (key == "output-encoding")
+    {
+      static const struct
+      {
+        const char *name;
+        OutputEncoding encoding;
+      } encodings[] = {
+          {"rgba8", OUTPUT_ENCODING_RGBA8},
+          {"rgb8", OUTPUT_ENCODING_RGB8},
+          {"bgr8", OUTPUT_ENCODING_BGR8},
+          {"mono8", OUTPUT_ENCODING_MONO8},
+          {"yuv420", OUTPUT_ENCODING_YUV420},
+          {"nv12", OUTPUT_ENCODING_NV12},
+          {"native", OUTPUT_ENCODING_NATIVE},
+      };
+
+      for (const auto &entry : encodings)
+      {
+        if (value == entry.name)
+        {
+          config.outputEncoding = entry.encoding;
+          return true;
+        }
+      }
+
+      ROS_ERROR("Invalid output-encoding %s, expected rgba8, rgb8, bgr8, mono8, yuv420, nv12 or native", value.c_str());
+      valid = false;
+      return true;
+    }
+
+    if (key == "encoder")
+    {
+      if (value == "h264")
+      {
+        config.videoCodec = VIDEO_CODEC_H264;
+      }
+      else if (value == "h265")
+      {
+        config.videoCodec = VIDEO_CODEC_H265;
+      }
+      else
+      {
+        ROS_ERROR("Invalid encoder %s, expected h264 or h265", value.c_str());
+        valid = false;
+      }
+      return true;
+    }
+
+    if (key == "encoder-bitrate")
+    {
+      return parseCount(key, value, config.encoderBitrate, valid);
+    }
+
+    if (key == "encoder-gop")
+    {
+      return parseCount(key, value, config.encoderGop, valid);
+    }
+
+    if (key == "encoder-framerate")
+    {
+      return parseCount(key, value, config.encoderFramerate, valid);
+    }
+
+    if (key == "publish-rate")
+    {
+      char *end = nullptr;
+      config.publishRate = strtof(value.c_str(), &end);
+      if (value.empty() || *end != '\0' || !(config.publishRate >= 0.0f))
+      {
+        ROS_ERROR("Invalid publish-rate %s, expected a rate in Hz", value.c_str());
+        config.publishRate = 0.0f;
+        valid = false;
+      }
+      return true;
+    }
+
+    if (key == "raw-output")
+    {
+      return parseFlag(key, value, config.rawOutput, valid);
+    }
+
+    if (key == "frame-id")
+    {
+      if (value.empty())
+      {
+        ROS_ERROR("Invalid frame-id, expected a name");
+        valid = false;
+      }
+      config.frameId = value;
+      return true;
+    }
+
+    if (key == "rectify")
+    {
+      return parseFlag(key, value, config.rectify, valid);
+    }
+
+    if (key == "rectify-fov")
+    {
+      char *end = nullptr;
+      config.rectifyFov = strtof(value.c_str(), &end);
+      if (value.empty() || *end != '\0' || !(config.rectifyFov > 0.0f && config.rectifyFov < 180.0f))
+      {
+        ROS_ERROR("Invalid rectify-fov %s, expected a horizontal field of view in degrees below 180", value.c_str());
+        config.rectifyFov = 0.0f;
+        valid = false;
+      }
+      return true;
+    }
+
+    if (key == "rig-sensor")
+    {
+      if (value.empty())
+      {
+        ROS_ERROR("Invalid rig-sensor, expected a sensor name of the rig");
+        valid = false;
+      }
+      config.rigSensor = value;
+      return true;
+    }
+
+    if (key == "tensor")
+    {
+      if (value == "nchw")
+      {
+        config.tensorLayout = TENSOR_LAYOUT_NCHW;
+      }
+      else if (value == "nhwc")
+      {
+        config.tensorLayout = TENSOR_LAYOUT_NHWC;
+      }
+      else
+      {
+        ROS_ERROR("Invalid tensor %s, expected nchw or nhwc", value.c_str());
+        valid = false;
+      }
+      return true;
+    }
+
+    if (key == "tensor-type")
+    {
+      if (value == "uint8")
+      {
+        config.tensorDataType = TENSOR_DATA_TYPE_UINT8;
+      }
+      else if (value == "float32")
+      {
+        config.tensorDataType = TENSOR_DATA_TYPE_FLOAT32;
+      }
+      else if (value == "float16")
+      {
+        config.tensorDataType = TENSOR_DATA_TYPE_FLOAT16;
+      }
+      else
+      {
+        ROS_ERROR("Invalid tensor-type %s, expected uint8, float32 or float16", value.c_str());
+        valid = false;
+      }
+      return true;
+    }
+
+    if (key == "tensor-mean")
+    {
+      return parseChannels(key, value, config.tensorMean, false, valid);
+    }
+
+    if (key == "tensor-std")
+    {
+      return parseChannels(key, value, config.tensorStd, true, valid);
+    }
+
+    if (key == "tensor-order")
+    {
+      if (value == "rgb" || value == "bgr")
+      {
+        config.tensorBgr = value == "bgr";
+      }
+      else
+      {
+        ROS_ERROR("Invalid tensor-order %s, expected rgb or bgr", value.c_str());
+        valid = false;
+      }
+      return true;
+    }
+
+    if (key == "tensor-size")
+    {
+      char tail;
+      if (sscanf(value.c_str(), "%ux%u%c", &config.tensorWidth, &config.tensorHeight, &tail) != 2 ||
+          config.tensorWidth == 0 || config.tensorHeight == 0)
+      {
+        ROS_ERROR("Invalid tensor-size %s, expected <width>x<height>", value.c_str());
+        valid = false;
+      }
+      return true;
+    }
+
+    if (key == "output")
+    {
+      return parseOutput(value, config, valid);
+    }
+
+    if (key == "backpressure")
+    {
+      return parseBackpressure(value, config, valid);
+    }
+
+    return false;
+  }
+
+  bool parseCameraConfig(const std::string &params, CameraConfig &config, std::string &sensorParams)
+  {
+    bool valid = true;
+    sensorParams.clear();
+
+    size_t begin = 0;
+    while (begin <= params.size())
+    {
+      size_t end = params.find(',', begin);
+      if (end == std::string::npos)
+      {
+        end = params.size();
+      }
+
+      std::string entry = params.substr(begin, end - begin);
+      begin = end + 1;
+      if (entry.empty())
+      {
+        continue;
+      }
+
+      size_t assign = entry.find('=');
+      std::string key = entry.substr(0, assign);
+      std::string value = assign == std::string::npos ? "" : entry.substr(assign + 1);
+
+      if (!applyOption(key, value, config, valid))
+      {
+        if (!sensorParams.empty())
+        {
+          sensorParams += ",";
+        }
+        sensorParams += entry;
+      }
+    }
+
+    // the EGLStream carries RGBA frames only
+    if (config.outputDomain == OUTPUT_DOMAIN_CUDA && config.outputEncoding != OUTPUT_ENCODING_RGBA8)
+    {
+      ROS_ERROR("output-domain=cuda requires output-encoding=rgba8");
+      valid = false;
+    }
+
+    // integer tensors hold the plain 8 bit values
+    if (config.tensorDataType == TENSOR_DATA_TYPE_UINT8)
+    {
+      for (uint32_t c = 0; c < 3; ++c)
+      {
+        if (config.tensorMean[c] != 0.0f || config.tensorStd[c] != 1.0f)
+        {
+          ROS_ERROR("tensor-mean and tensor-std require tensor-type=float32 or float16");
+          valid = false;
+          break;
+        }
+      }
+    }
+
+    // the remap kernel reads and writes RGBA frames, its model comes from the rig
+    if (config.rectify && config.outputEncoding != OUTPUT_ENCODING_RGBA8)
+    {
+      ROS_ERROR("rectify=true requires output-encoding=rgba8");
+      valid = false;
+    }
+    if (config.rectify && config.rigSensor.empty())
+    {
+      ROS_ERROR("rectify=true requires the rig-sensor of the camera model");
+      valid = false;
+    }
+
+    if (!config.rawOutput && config.videoCodec == VIDEO_CODEC_NONE && config.tensorLayout == TENSOR_LAYOUT_NONE)
+    {
+      ROS_ERROR("raw-output=false requires an encoder or a tensor");
+      valid = false;
+    }
+
+    return valid;
+  }
+
+  BackpressureConfig findBackpressure(const CameraConfig &config, const std::string &output)
+  {
+    const BackpressureConfig *all = nullptr;
+    const BackpressureConfig *named = nullptr;
+    for (const BackpressureConfig &backpressure : config.backpressure)
+    {
+      if (backpressure.output.empty())
+      {
+        all = &backpressure;
+      }
+      else if (backpressure.output == output)
+      {
+        named = &backpressure;
+      }
+    }
+
+    return named ? *named : all ? *all : BackpressureConfig();
+  }
+
+  const char *getBackpressureName(BackpressurePolicy policy)
+  {
+    switch (policy)
+    {
+    case BACKPRESSURE_DROP_NEWEST:
+      return "drop-newest";
+    case BACKPRESSURE_BLOCK:
+      return "block";
+    default:
+      return "drop-oldest";
+    }
+  }
+
+} // namespace nv
@@ -0,0 +1,153 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "camera_encoder.h"
+
+#include <sensor_msgs/CompressedImage.h>
+
+namespace nv
+{
+
+  CameraEncoder::~CameraEncoder()
+  {
+    release();
+  }
+
+  bool CameraEncoder::initialize(dwSensorHandle_t camera, const CameraConfig &config, ros::NodeHandle &nh,
+                                 const std::string &topic, const std::string &frameId,
+                                 const TimeMapper &clock)
+  {
+    m_format = config.videoCodec == VIDEO_CODEC_H265 ? "h265" : "h264";
+    m_frameId = frameId;
+    m_clock = &clock;
+
+    // packets are delivered to onData() instead of a file
+    std::string params = "type=user,format=" + m_format +
+                         ",bitrate=" + std::to_string(config.encoderBitrate) +
+                         ",framerate=" + std::to_string(config.encoderFramerate) +
+                         ",gop-size=" + std::to_string(config.encoderGop);
+
+    dwSerializerParams serializerParams{};
+    serializerParams.parameters = params.c_str();
+    serializerParams.onData = &CameraEncoder::onData;
+    serializerParams.userData = this;
+
+    dwStatus status = dwSensorSerializer_initialize(&m_serializer, &serializerParams, camera);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot create %s encoder with %s. Error: %s", m_format.c_str(), params.c_str(), dwGetStatusName(status));
+      m_serializer = DW_NULL_HANDLE;
+      return false;
+    }
+
+    m_publisher = nh.advertise<sensor_msgs::CompressedImage>(topic + "/" + m_format, 10);
+
+    ROS_INFO("%s packets being published on topic /%s/%s", m_format.c_str(), topic.c_str(), m_format.c_str());
+
+    return true;
+  }
+
+  bool CameraEncoder::start()
+  {
+    if (m_started)
+    {
+      return true;
+    }
+
+    // the serializer thread is not running, frames queued before a stop all got their packets or were discarded
+    m_queued.reset();
+    m_timestamp = 0;
+    m_seq = 0;
+
+    dwStatus status = dwSensorSerializer_start(m_serializer);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot start %s encoder. Error: %s", m_format.c_str(), dwGetStatusName(status));
+      return false;
+    }
+    m_started = true;
+
+    return true;
+  }
+
+  void CameraEncoder::stop()
+  {
+    if (m_started)
+    {
+      dwSensorSerializer_stop(m_serializer);
+      m_started = false;
+    }
+  }
+
+  void CameraEncoder::release()
+  {
+    stop();
+    if (m_serializer)
+    {
+      dwSensorSerializer_release(m_serializer);
+      m_serializer = DW_NULL_HANDLE;
+    }
+
+    m_publisher.shutdown();
+  }
+
+  bool CameraEncoder::encode(dwCameraFrameHandle_t frame, uint32_t seq)
+  {
+    dwTime_t timestamp = 0;
+    dwSensorCamera_getTimestamp(&timestamp, frame);
+    if (!m_queued.push(timestamp, seq))
+    {
+      ROS_WARN_THROTTLE(1.0, "%s encoder is %u frames behind, skipping frame", m_format.c_str(),
+                        FrameStampQueue::CAPACITY);
+      return true;
+    }
+
+    dwStatus status = dwSensorSerializer_serializeCameraFrameAsync(frame, m_serializer);
+    if (status != DW_SUCCESS)
+    {
+      m_queued.cancel();
+      ROS_ERROR("dwSensorSerializer_serializeCameraFrameAsync() failed. Error: %s", dwGetStatusName(status));
+      return false;
+    }
+
+    return true;
+  }
+
+  // called on the serializer thread for every encoded packet
+  void CameraEncoder::onData(const uint8_t *data, size_t size, void *userData)
+  {
+    CameraEncoder *encoder = static_cast<CameraEncoder *>(userData);
+
+    // parameter sets carry the stamp of the frame they precede, the rest of a split frame that of the frame
+    int64_t timestamp = encoder->m_timestamp;
+    uint32_t seq = encoder->m_seq;
+    const VideoPacketContent content = classifyVideoPacket(data, size, encoder->m_format == "h265");
+    if (content == VIDEO_PACKET_FRAME && encoder->m_queued.pop(timestamp, seq))
+    {
+      encoder->m_timestamp = timestamp;
+      encoder->m_seq = seq;
+    }
+    else if (content == VIDEO_PACKET_HEADER)
+    {
+      encoder->m_queued.peek(timestamp, seq);
+    }
+
+    sensor_msgs::CompressedImagePtr packet(new sensor_msgs::CompressedImage);
+    packet->header.stamp = encoder->m_clock->toStamp(timestamp);
+    packet->header.seq = seq;
+    packet->header.frame_id = encoder->m_frameId;
+    packet->format = encoder->m_format;
+    packet->data.assign(data, data + size);
+
+    encoder->m_publisher.publish(packet);
+  }
+
+} // namespace nv
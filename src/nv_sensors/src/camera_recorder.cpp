@@ -0,0 +1,349 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "camera_recorder.h"
+
+#include <ros/ros.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace nv
+{
+
+  const uint64_t CameraRecorder::DEFAULT_SEGMENT_SIZE;
+
+  // dirty pages of a segment are handed to the writeback every FLUSH_SIZE bytes
+  static const uint64_t FLUSH_SIZE = 16ULL << 20;
+
+  CameraRecorder::~CameraRecorder()
+  {
+    stop();
+  }
+
+  bool CameraRecorder::start(dwSensorHandle_t camera, const CameraConfig &config, const std::string &prefix,
+                             const std::string &format, uint64_t segmentSize)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_serializer)
+    {
+      ROS_WARN("recording %s is already running", m_prefix.c_str());
+      return false;
+    }
+
+    const uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    m_prefix = prefix;
+    m_format = format;
+    m_segmentSize = (std::max<uint64_t>(segmentSize, page) + page - 1) / page * page;
+    m_segment = 0;
+    m_used = 0;
+    m_flushed = 0;
+    m_failed = false;
+    m_entryOpen = false;
+    m_header.size = 0;
+    m_queued.reset();
+    m_frames = 0;
+    m_bytes = 0;
+    m_dropped = 0;
+
+    const std::string indexPath = m_prefix + ".idx";
+    m_index = fopen(indexPath.c_str(), "wb");
+    if (!m_index)
+    {
+      ROS_ERROR("Cannot create record index %s. Error: %s", indexPath.c_str(), strerror(errno));
+      return false;
+    }
+
+    // the first segment is mapped before the first packet arrives
+    if (!openSegment())
+    {
+      fclose(m_index);
+      m_index = nullptr;
+      return false;
+    }
+
+    // packets are delivered to onData() instead of a file
+    std::string params = "type=user,format=" + m_format;
+    if (m_format != "raw")
+    {
+      params += ",bitrate=" + std::to_string(config.encoderBitrate) +
+                ",framerate=" + std::to_string(config.encoderFramerate) +
+                ",gop-size=" + std::to_string(config.encoderGop);
+    }
+
+    dwSerializerParams serializerParams{};
+    serializerParams.parameters = params.c_str();
+    serializerParams.onData = &CameraRecorder::onData;
+    serializerParams.userData = this;
+
+    dwStatus status = dwSensorSerializer_initialize(&m_serializer, &serializerParams, camera);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot create %s recorder with %s. Error: %s", m_format.c_str(), params.c_str(), dwGetStatusName(status));
+      m_serializer = DW_NULL_HANDLE;
+      closeSegment();
+      fclose(m_index);
+      m_index = nullptr;
+      return false;
+    }
+
+    status = dwSensorSerializer_start(m_serializer);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot start %s recorder. Error: %s", m_format.c_str(), dwGetStatusName(status));
+      dwSensorSerializer_release(m_serializer);
+      m_serializer = DW_NULL_HANDLE;
+      closeSegment();
+      fclose(m_index);
+      m_index = nullptr;
+      return false;
+    }
+
+    m_recording = true;
+    ROS_INFO("recording %s to %s_*.%s, %lu MB segments", m_format.c_str(), m_prefix.c_str(), m_format.c_str(),
+             m_segmentSize >> 20);
+
+    return true;
+  }
+
+  void CameraRecorder::stop()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_serializer)
+    {
+      return;
+    }
+
+    // stopping the serializer writes the queued frames
+    m_recording = false;
+    dwSensorSerializer_stop(m_serializer);
+    dwSensorSerializer_release(m_serializer);
+    m_serializer = DW_NULL_HANDLE;
+
+    writeEntry();
+    closeSegment();
+    fclose(m_index);
+    m_index = nullptr;
+
+    ROS_INFO("recording %s stopped, %lu frames (dropped %lu), %lu MB in %u segments", m_prefix.c_str(), getFrames(),
+             getDropped(), getBytes() >> 20, m_segment + (m_used > 0 ? 1 : 0));
+  }
+
+  void CameraRecorder::record(dwCameraFrameHandle_t frame)
+  {
+    // start() and stop() may hold the serializer for a while, a frame is never waited for
+    std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+    if (!lock.owns_lock() || !m_serializer)
+    {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    dwTime_t timestamp = 0;
+    dwSensorCamera_getTimestamp(&timestamp, frame);
+    if (!m_queued.push(timestamp, 0))
+    {
+      ROS_WARN_THROTTLE(1.0, "recording %s is %u frames behind, dropping frame", m_prefix.c_str(),
+                        FrameStampQueue::CAPACITY);
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    dwStatus status = dwSensorSerializer_serializeCameraFrameAsync(frame, m_serializer);
+    if (status != DW_SUCCESS)
+    {
+      m_queued.cancel();
+      ROS_WARN_THROTTLE(1.0, "recording %s dropped a frame. Error: %s", m_prefix.c_str(), dwGetStatusName(status));
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    m_frames.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // called on the serializer thread for every packet
+  void CameraRecorder::onData(const uint8_t *data, size_t size, void *userData)
+  {
+    CameraRecorder *recorder = static_cast<CameraRecorder *>(userData);
+
+    // the raw serializer writes every frame in one packet
+    const VideoPacketContent content =
+        recorder->m_format == "raw" ? VIDEO_PACKET_FRAME : classifyVideoPacket(data, size, recorder->m_format == "h265");
+    int64_t timestamp = 0;
+    uint32_t seq = 0;
+    if (content == VIDEO_PACKET_FRAME)
+    {
+      recorder->m_queued.pop(timestamp, seq);
+    }
+    if (recorder->m_failed)
+    {
+      return;
+    }
+
+    RecordIndexEntry &header = recorder->m_header;
+    RecordIndexEntry &entry = recorder->m_entry;
+    if (content == VIDEO_PACKET_FRAME)
+    {
+      // the previous frame is complete, the parameter sets before this one start its entry
+      if (!recorder->writeEntry())
+      {
+        return;
+      }
+      entry.timestamp = timestamp;
+      entry.segment = header.size > 0 ? header.segment : recorder->m_segment;
+      entry.offset = header.size > 0 ? header.offset : recorder->m_used;
+      entry.size = header.size + size;
+      header.size = 0;
+      recorder->m_entryOpen = true;
+    }
+    else if (content == VIDEO_PACKET_HEADER || header.size > 0 || !recorder->m_entryOpen)
+    {
+      if (header.size == 0)
+      {
+        header.segment = recorder->m_segment;
+        header.offset = recorder->m_used;
+      }
+      header.size += size;
+    }
+    else
+    {
+      entry.size += size;
+    }
+
+    recorder->write(data, size);
+  }
+
+  bool CameraRecorder::writeEntry()
+  {
+    if (!m_entryOpen || m_failed)
+    {
+      return !m_failed;
+    }
+
+    m_entryOpen = false;
+    if (fwrite(&m_entry, sizeof(m_entry), 1, m_index) != 1)
+    {
+      ROS_ERROR("Cannot write record index %s.idx, recording stopped. Error: %s", m_prefix.c_str(), strerror(errno));
+      m_failed = true;
+      return false;
+    }
+
+    return true;
+  }
+
+  void CameraRecorder::write(const uint8_t *data, size_t size)
+  {
+    while (size > 0)
+    {
+      if (!m_mapping && !openSegment())
+      {
+        ROS_ERROR("recording %s stopped, no segment to write to", m_prefix.c_str());
+        m_failed = true;
+        return;
+      }
+
+      // a packet crossing the end of a segment continues in the next one
+      const size_t chunk = static_cast<size_t>(std::min<uint64_t>(size, m_segmentSize - m_used));
+      memcpy(m_mapping + m_used, data, chunk);
+      m_used += chunk;
+      data += chunk;
+      size -= chunk;
+      m_bytes.fetch_add(chunk, std::memory_order_relaxed);
+
+      if (m_used == m_segmentSize)
+      {
+        closeSegment();
+        m_segment++;
+        m_used = 0;
+        m_flushed = 0;
+      }
+      else if (m_used - m_flushed >= FLUSH_SIZE)
+      {
+        flushSegment(false);
+      }
+    }
+  }
+
+  bool CameraRecorder::openSegment()
+  {
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), "_%05u.", m_segment);
+    const std::string path = m_prefix + suffix + m_format;
+
+    m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (m_fd < 0)
+    {
+      ROS_ERROR("Cannot create record segment %s. Error: %s", path.c_str(), strerror(errno));
+      return false;
+    }
+
+    // blocks are reserved up front, writing a packet never allocates on the file system
+    int error = posix_fallocate(m_fd, 0, static_cast<off_t>(m_segmentSize));
+    if (error != 0 && ftruncate(m_fd, static_cast<off_t>(m_segmentSize)) != 0)
+    {
+      ROS_ERROR("Cannot allocate %lu bytes for record segment %s. Error: %s", m_segmentSize, path.c_str(),
+                strerror(error));
+      close(m_fd);
+      m_fd = -1;
+      return false;
+    }
+
+    void *mapping = mmap(nullptr, m_segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+      ROS_ERROR("Cannot map record segment %s. Error: %s", path.c_str(), strerror(errno));
+      close(m_fd);
+      m_fd = -1;
+      return false;
+    }
+    madvise(mapping, m_segmentSize, MADV_SEQUENTIAL);
+    m_mapping = static_cast<uint8_t *>(mapping);
+
+    return true;
+  }
+
+  void CameraRecorder::flushSegment(bool all)
+  {
+    // starts the writeback of the filled pages, so a segment is not written in one burst when it is closed
+    if (m_used > m_flushed)
+    {
+      sync_file_range(m_fd, static_cast<off_t>(m_flushed), static_cast<off_t>(m_used - m_flushed),
+                      all ? SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE : SYNC_FILE_RANGE_WRITE);
+      m_flushed = m_used;
+    }
+  }
+
+  void CameraRecorder::closeSegment()
+  {
+    if (!m_mapping)
+    {
+      return;
+    }
+
+    flushSegment(true);
+    munmap(m_mapping, m_segmentSize);
+    m_mapping = nullptr;
+
+    // the last segment ends with its data
+    if (m_used < m_segmentSize && ftruncate(m_fd, static_cast<off_t>(m_used)) != 0)
+    {
+      ROS_WARN("Cannot trim record segment %u of %s. Error: %s", m_segment, m_prefix.c_str(), strerror(errno));
+    }
+    close(m_fd);
+    m_fd = -1;
+  }
+
+} // namespace nv
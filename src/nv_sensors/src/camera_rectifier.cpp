@@ -0,0 +1,229 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "camera_rectifier.h"
+
+#include <dw/rig/Rig.h>
+#include <ros/ros.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace nv
+{
+
+  // widest default field of view of the pinhole camera, wider lenses are cropped to it
+  static const float MAX_DEFAULT_FOV = 120.0f * static_cast<float>(M_PI) / 180.0f;
+
+  CameraRectifier::~CameraRectifier()
+  {
+    release();
+  }
+
+  bool CameraRectifier::initialize(dwContextHandle_t context, const std::string &rigPath, const CameraConfig &config,
+                                   const dwImageProperties &frameProperties)
+  {
+    if (!createModels(context, rigPath, config, frameProperties.width, frameProperties.height))
+    {
+      release();
+      return false;
+    }
+
+    // the distortion map is computed here, once
+    dwStatus status = dwRectifier_initialize(&m_rectifier, m_cameraModel, m_pinholeModel, context);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot initialize rectifier of %s. Error: %s", config.rigSensor.c_str(), dwGetStatusName(status));
+      m_rectifier = DW_NULL_HANDLE;
+      release();
+      return false;
+    }
+
+    dwImageProperties rectifiedProperties = frameProperties;
+    rectifiedProperties.type = DW_IMAGE_CUDA;
+    status = dwImage_create(&m_rectified, rectifiedProperties, context);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot create rectified image of %s. Error: %s", config.rigSensor.c_str(), dwGetStatusName(status));
+      m_rectified = DW_NULL_HANDLE;
+      release();
+      return false;
+    }
+
+    if (frameProperties.type != DW_IMAGE_CUDA)
+    {
+      status = dwImageStreamer_initialize(&m_streamer, &frameProperties, DW_IMAGE_CUDA, context);
+      if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("Cannot initialize rectifier streamer of %s. Error: %s", config.rigSensor.c_str(),
+                  dwGetStatusName(status));
+        m_streamer = DW_NULL_HANDLE;
+        release();
+        return false;
+      }
+    }
+
+    ROS_INFO("rectifying %s to a %ux%u pinhole camera, focal length %.1f px", config.rigSensor.c_str(),
+             frameProperties.width, frameProperties.height, m_intrinsics.focalX);
+
+    return true;
+  }
+
+  bool CameraRectifier::createModels(dwContextHandle_t context, const std::string &rigPath, const CameraConfig &config,
+                                     uint32_t width, uint32_t height)
+  {
+    if (rigPath.empty())
+    {
+      ROS_ERROR("rectify=true requires the camera models of a rig, ~rig is not set");
+      return false;
+    }
+
+    dwRigHandle_t rig = DW_NULL_HANDLE;
+    dwStatus status = dwRig_initializeFromFile(&rig, context, rigPath.c_str());
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot load rig %s. Error: %s", rigPath.c_str(), dwGetStatusName(status));
+      return false;
+    }
+
+    uint32_t sensorId = 0;
+    status = dwRig_findSensorByName(&sensorId, config.rigSensor.c_str(), rig);
+    if (status == DW_SUCCESS)
+    {
+      status = dwCameraModel_initialize(&m_cameraModel, sensorId, rig);
+    }
+    dwRig_release(rig);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot read the camera model of %s from rig %s. Error: %s", config.rigSensor.c_str(), rigPath.c_str(),
+                dwGetStatusName(status));
+      m_cameraModel = DW_NULL_HANDLE;
+      return false;
+    }
+
+    // the rig intrinsics may be calibrated at another resolution than the camera delivers
+    uint32_t modelWidth = 0;
+    uint32_t modelHeight = 0;
+    dwCameraModel_getImageSize(&modelWidth, &modelHeight, m_cameraModel);
+    if (modelWidth != 0 && modelWidth != width)
+    {
+      dwCameraModel_setModelScale(static_cast<float>(width) / modelWidth, m_cameraModel);
+    }
+
+    float fov = config.rectifyFov * static_cast<float>(M_PI) / 180.0f;
+    if (fov <= 0.0f)
+    {
+      float lensFov = MAX_DEFAULT_FOV;
+      dwCameraModel_getHorizontalFOV(&lensFov, m_cameraModel);
+      fov = std::min(lensFov, MAX_DEFAULT_FOV);
+    }
+
+    m_intrinsics.focalX = 0.5f * width / std::tan(0.5f * fov);
+    m_intrinsics.focalY = m_intrinsics.focalX;
+    m_intrinsics.u0 = 0.5f * width;
+    m_intrinsics.v0 = 0.5f * height;
+
+    dwPinholeCameraConfig pinhole{};
+    pinhole.width = width;
+    pinhole.height = height;
+    pinhole.focalX = m_intrinsics.focalX;
+    pinhole.focalY = m_intrinsics.focalY;
+    pinhole.u0 = m_intrinsics.u0;
+    pinhole.v0 = m_intrinsics.v0;
+    status = dwCameraModel_initializePinhole(&m_pinholeModel, &pinhole, context);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot create the pinhole model of %s. Error: %s", config.rigSensor.c_str(), dwGetStatusName(status));
+      m_pinholeModel = DW_NULL_HANDLE;
+      return false;
+    }
+
+    return true;
+  }
+
+  void CameraRectifier::release()
+  {
+    if (m_streamer)
+    {
+      dwImageStreamer_release(m_streamer);
+      m_streamer = DW_NULL_HANDLE;
+    }
+    if (m_rectified)
+    {
+      dwImage_destroy(m_rectified);
+      m_rectified = DW_NULL_HANDLE;
+    }
+    if (m_rectifier)
+    {
+      dwRectifier_release(m_rectifier);
+      m_rectifier = DW_NULL_HANDLE;
+    }
+    if (m_pinholeModel)
+    {
+      dwCameraModel_release(m_pinholeModel);
+      m_pinholeModel = DW_NULL_HANDLE;
+    }
+    if (m_cameraModel)
+    {
+      dwCameraModel_release(m_cameraModel);
+      m_cameraModel = DW_NULL_HANDLE;
+    }
+    m_intrinsics = PinholeIntrinsics();
+  }
+
+  bool CameraRectifier::rectify(dwImageHandle_t frame, dwTime_t timeoutUs)
+  {
+    dwImageHandle_t input = frame;
+    dwStatus status;
+    if (m_streamer)
+    {
+      status = dwImageStreamer_producerSend(frame, m_streamer);
+      if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("dwImageStreamer_producerSend() of the rectifier failed. Error: %s", dwGetStatusName(status));
+        return false;
+      }
+      status = dwImageStreamer_consumerReceive(&input, timeoutUs, m_streamer);
+      if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("dwImageStreamer_consumerReceive() of the rectifier failed. Error: %s", dwGetStatusName(status));
+        dwImageStreamer_producerReturn(nullptr, timeoutUs, m_streamer);
+        return false;
+      }
+    }
+
+    dwImageCUDA *in = nullptr;
+    dwImageCUDA *out = nullptr;
+    status = dwImage_getCUDA(&in, input);
+    if (status == DW_SUCCESS)
+    {
+      status = dwImage_getCUDA(&out, m_rectified);
+    }
+    if (status == DW_SUCCESS)
+    {
+      // pixels seen by no lens ray are black
+      status = dwRectifier_warp(out, in, true, m_rectifier);
+    }
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("dwRectifier_warp() failed. Error: %s", dwGetStatusName(status));
+    }
+
+    if (m_streamer)
+    {
+      dwImageStreamer_consumerReturn(&input, m_streamer);
+      dwImageStreamer_producerReturn(nullptr, timeoutUs, m_streamer);
+    }
+
+    return status == DW_SUCCESS;
+  }
+
+} // namespace nv
@@ -0,0 +1,100 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "capture_health.h"
+
+#include <ros/ros.h>
+
+#include <algorithm>
+
+namespace nv
+{
+
+  const int64_t CaptureHealth::STALL_TIME_US;
+  const int64_t CaptureHealth::MAX_BACKOFF_US;
+
+  void CaptureHealth::initialize(uint32_t index, int64_t framePeriodUs)
+  {
+    m_index = index;
+    m_framePeriodUs = framePeriodUs > 0 ? framePeriodUs : 33333;
+    m_state = HEALTHY;
+    m_missed = 0;
+    m_consecutive = 0;
+    m_missedTime = 0;
+    m_backoff = 0;
+  }
+
+  void CaptureHealth::onFrame()
+  {
+    if (m_consecutive > 0)
+    {
+      if (getState() == STALLED)
+      {
+        ROS_INFO("camera %u recovered after %.1f s without frames", m_index, m_missedTime / 1e6);
+      }
+      else
+      {
+        ROS_DEBUG("camera %u recovered after %lu missed reads", m_index, m_consecutive);
+      }
+    }
+
+    m_state.store(HEALTHY, std::memory_order_relaxed);
+    m_consecutive = 0;
+    m_missedTime = 0;
+    m_backoff = 0;
+  }
+
+  int64_t CaptureHealth::onMissed(const char *reason, bool waited)
+  {
+    m_missed.fetch_add(1, std::memory_order_relaxed);
+    m_consecutive++;
+
+    // a read returning at once waits one frame period before the retry
+    int64_t wait = waited ? 0 : m_framePeriodUs;
+    m_missedTime += waited ? getReadTimeout() : m_framePeriodUs;
+
+    const State state = getState();
+    if (state == HEALTHY)
+    {
+      ROS_WARN("camera %u readFrame %s, waiting for the sensor", m_index, reason);
+      m_state.store(DEGRADED, std::memory_order_relaxed);
+    }
+    else if (state == DEGRADED && m_missedTime >= STALL_TIME_US)
+    {
+      ROS_ERROR("camera %u stalled, no frame for %.1f s (%s), backing off up to %.1f s between reads", m_index,
+                m_missedTime / 1e6, reason, MAX_BACKOFF_US / 1e6);
+      m_state.store(STALLED, std::memory_order_relaxed);
+      m_backoff = m_framePeriodUs;
+    }
+    else if (state == STALLED)
+    {
+      m_backoff = std::min(2 * m_backoff, MAX_BACKOFF_US);
+      wait = std::max(wait, m_backoff);
+      m_missedTime += wait;
+    }
+
+    return wait;
+  }
+
+  const char *CaptureHealth::getStateName() const
+  {
+    switch (getState())
+    {
+    case DEGRADED:
+      return "degraded";
+    case STALLED:
+      return "stalled";
+    default:
+      return "healthy";
+    }
+  }
+
+} // namespace nv
@@ -0,0 +1,342 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "egl_stream_producer.h"
+#include "nvcommon.h"
+
+#include <ros/ros.h>
+#include <cuda_runtime.h>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace nv
+{
+
+  // passes a file descriptor to the peer of a UNIX domain socket
+  static bool sendFileDescriptor(int socket, int fd)
+  {
+    char payload = 0;
+    struct iovec iov;
+    iov.iov_base = &payload;
+    iov.iov_len = sizeof(payload);
+
+    char control[CMSG_SPACE(sizeof(int))];
+    memset(control, 0, sizeof(control));
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+    return sendmsg(socket, &msg, 0) == static_cast<ssize_t>(sizeof(payload));
+  }
+
+  EglStreamProducer::~EglStreamProducer()
+  {
+    release();
+  }
+
+  bool EglStreamProducer::loadExtensions()
+  {
+    m_eglQueryDevicesEXT = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(eglGetProcAddress("eglQueryDevicesEXT"));
+    m_eglGetPlatformDisplayEXT = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    m_eglCreateStreamKHR = reinterpret_cast<PFNEGLCREATESTREAMKHRPROC>(eglGetProcAddress("eglCreateStreamKHR"));
+    m_eglDestroyStreamKHR = reinterpret_cast<PFNEGLDESTROYSTREAMKHRPROC>(eglGetProcAddress("eglDestroyStreamKHR"));
+    m_eglQueryStreamKHR = reinterpret_cast<PFNEGLQUERYSTREAMKHRPROC>(eglGetProcAddress("eglQueryStreamKHR"));
+    m_eglGetStreamFileDescriptorKHR = reinterpret_cast<PFNEGLGETSTREAMFILEDESCRIPTORKHRPROC>(eglGetProcAddress("eglGetStreamFileDescriptorKHR"));
+
+    return m_eglQueryDevicesEXT && m_eglGetPlatformDisplayEXT && m_eglCreateStreamKHR && m_eglDestroyStreamKHR &&
+           m_eglQueryStreamKHR && m_eglGetStreamFileDescriptorKHR;
+  }
+
+  bool EglStreamProducer::initialize(const std::string &socketPath, uint32_t width, uint32_t height)
+  {
+    m_socketPath = socketPath;
+    m_width = width;
+    m_height = height;
+
+    if (!loadExtensions())
+    {
+      ROS_ERROR("EGLStream extensions are not available");
+      return false;
+    }
+
+    // headless display on the first EGL device
+    EGLDeviceEXT devices[DEFAULT_DISPLAY_ID + 1];
+    EGLint deviceCount = 0;
+    if (!m_eglQueryDevicesEXT(DEFAULT_DISPLAY_ID + 1, devices, &deviceCount) || deviceCount < 1)
+    {
+      ROS_ERROR("No EGL device found");
+      return false;
+    }
+
+    m_display = m_eglGetPlatformDisplayEXT(EGL_PLATFORM_DEVICE_EXT, devices[DEFAULT_DISPLAY_ID], nullptr);
+    if (m_display == EGL_NO_DISPLAY || !eglInitialize(m_display, nullptr, nullptr))
+    {
+      ROS_ERROR("Cannot initialize EGL display. Error: 0x%x", eglGetError());
+      m_display = EGL_NO_DISPLAY;
+      return false;
+    }
+
+    m_listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listenSocket < 0)
+    {
+      ROS_ERROR("Cannot create EGLStream socket %s. Error: %s", m_socketPath.c_str(), strerror(errno));
+      release();
+      return false;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, m_socketPath.c_str(), sizeof(address.sun_path) - 1);
+    unlink(m_socketPath.c_str());
+
+    if (bind(m_listenSocket, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(m_listenSocket, 1) != 0)
+    {
+      ROS_ERROR("Cannot listen on EGLStream socket %s. Error: %s", m_socketPath.c_str(), strerror(errno));
+      release();
+      return false;
+    }
+
+    m_run = true;
+    m_acceptThread = std::thread(&EglStreamProducer::run_accept, this);
+
+    ROS_INFO("EGLStream consumers can connect on %s", m_socketPath.c_str());
+
+    return true;
+  }
+
+  void EglStreamProducer::release()
+  {
+    m_run = false;
+    if (m_acceptThread.joinable())
+    {
+      m_acceptThread.join();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      disconnectConsumer();
+    }
+
+    if (m_listenSocket >= 0)
+    {
+      close(m_listenSocket);
+      unlink(m_socketPath.c_str());
+      m_listenSocket = -1;
+    }
+
+    if (m_display != EGL_NO_DISPLAY)
+    {
+      eglTerminate(m_display);
+      m_display = EGL_NO_DISPLAY;
+    }
+  }
+
+  void EglStreamProducer::run_accept()
+  {
+    while (m_run)
+    {
+      struct pollfd listener;
+      listener.fd = m_listenSocket;
+      listener.events = POLLIN;
+      listener.revents = 0;
+
+      if (poll(&listener, 1, MAX_SERVICE_WAIT_TIMEOUT_MS) <= 0)
+      {
+        continue;
+      }
+
+      int client = accept(m_listenSocket, nullptr, nullptr);
+      if (client < 0)
+      {
+        continue;
+      }
+
+      // only one consumer per stream, a consumer which went away is dropped by isConnected()
+      if (isConnected())
+      {
+        ROS_WARN("EGLStream %s already has a consumer, rejecting connection", m_socketPath.c_str());
+      }
+      else if (connectConsumer(client))
+      {
+        ROS_INFO("EGLStream consumer connected on %s", m_socketPath.c_str());
+      }
+
+      close(client);
+    }
+  }
+
+  bool EglStreamProducer::connectConsumer(int client)
+  {
+    // the CUDA driver API calls below need the primary context on this thread
+    cudaFree(nullptr);
+
+    // mailbox mode, a slow consumer never blocks the producer
+    const EGLint streamAttributes[] = {EGL_STREAM_FIFO_LENGTH_KHR, 0, EGL_NONE};
+    EGLStreamKHR stream = m_eglCreateStreamKHR(m_display, streamAttributes);
+    if (stream == EGL_NO_STREAM_KHR)
+    {
+      ROS_ERROR("eglCreateStreamKHR() failed. Error: 0x%x", eglGetError());
+      return false;
+    }
+
+    EGLNativeFileDescriptorKHR fd = m_eglGetStreamFileDescriptorKHR(m_display, stream);
+    if (fd == EGL_NO_FILE_DESCRIPTOR_KHR || !sendFileDescriptor(client, fd))
+    {
+      ROS_ERROR("Cannot pass EGLStream to consumer on %s", m_socketPath.c_str());
+      if (fd != EGL_NO_FILE_DESCRIPTOR_KHR)
+      {
+        close(fd);
+      }
+      m_eglDestroyStreamKHR(m_display, stream);
+      return false;
+    }
+    close(fd);
+
+    // wait for the consumer side to attach before connecting the producer
+    EGLint state = EGL_STREAM_STATE_CREATED_KHR;
+    for (uint32_t i = 0; i < MAX_WAIT_TIMEOUT_FRAMES && m_run; ++i)
+    {
+      if (!m_eglQueryStreamKHR(m_display, stream, EGL_STREAM_STATE_KHR, &state) ||
+          state != EGL_STREAM_STATE_CREATED_KHR)
+      {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(ONE_FRAME_TIME_US_30_FPS));
+    }
+
+    if (state != EGL_STREAM_STATE_CONNECTING_KHR)
+    {
+      ROS_ERROR("EGLStream consumer on %s did not connect", m_socketPath.c_str());
+      m_eglDestroyStreamKHR(m_display, stream);
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    CUresult result = cuEGLStreamProducerConnect(&m_connection, stream, m_width, m_height);
+    if (result != CUDA_SUCCESS)
+    {
+      ROS_ERROR("cuEGLStreamProducerConnect() failed. Error: %d", result);
+      m_eglDestroyStreamKHR(m_display, stream);
+      return false;
+    }
+
+    m_stream = stream;
+    m_connected = true;
+
+    return true;
+  }
+
+  void EglStreamProducer::disconnectConsumer()
+  {
+    if (m_connected)
+    {
+      cuEGLStreamProducerDisconnect(&m_connection);
+      m_connected = false;
+    }
+
+    if (m_stream != EGL_NO_STREAM_KHR)
+    {
+      m_eglDestroyStreamKHR(m_display, m_stream);
+      m_stream = EGL_NO_STREAM_KHR;
+    }
+  }
+
+  bool EglStreamProducer::isConnected()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_connected)
+    {
+      return false;
+    }
+
+    EGLint state = EGL_STREAM_STATE_DISCONNECTED_KHR;
+    m_eglQueryStreamKHR(m_display, m_stream, EGL_STREAM_STATE_KHR, &state);
+    if (state == EGL_STREAM_STATE_DISCONNECTED_KHR)
+    {
+      ROS_INFO("EGLStream consumer on %s disconnected", m_socketPath.c_str());
+      disconnectConsumer();
+      return false;
+    }
+
+    return true;
+  }
+
+  bool EglStreamProducer::present(void *dptr, size_t pitch)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_connected)
+    {
+      return false;
+    }
+
+    CUeglFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.frame.pPitch[0] = dptr;
+    frame.width = m_width;
+    frame.height = m_height;
+    frame.depth = 1;
+    frame.pitch = static_cast<unsigned int>(pitch);
+    frame.planeCount = 1;
+    frame.numChannels = 4;
+    frame.frameType = CU_EGL_FRAME_TYPE_PITCH;
+    // R, G, B, A byte order in memory
+    frame.eglColorFormat = CU_EGL_COLOR_FORMAT_ABGR;
+    frame.cuFormat = CU_AD_FORMAT_UNSIGNED_INT8;
+
+    CUresult result = cuEGLStreamProducerPresentFrame(&m_connection, frame, nullptr);
+    if (result != CUDA_SUCCESS)
+    {
+      ROS_WARN("cuEGLStreamProducerPresentFrame() failed. Error: %d", result);
+      disconnectConsumer();
+      return false;
+    }
+
+    return true;
+  }
+
+  void *EglStreamProducer::reclaim()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_connected)
+    {
+      return nullptr;
+    }
+
+    CUeglFrame frame;
+    if (cuEGLStreamProducerReturnFrame(&m_connection, &frame, nullptr) != CUDA_SUCCESS)
+    {
+      return nullptr;
+    }
+
+    return frame.frame.pPitch[0];
+  }
+
+} // namespace nv
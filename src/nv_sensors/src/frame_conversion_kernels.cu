@@ -0,0 +1,101 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "frame_conversion_kernels.h"
+#include "conversion_sampling.cuh"
+
+namespace nv
+{
+
+  // one thread per output pixel, the format pair and the scale are fixed per instantiation
+  template <TensorSourceFormat Format, int Scale, int Channels>
+  __global__ void convertResize(FrameConversion conversion)
+  {
+    const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+    const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+    if (x >= conversion.width || y >= conversion.height)
+    {
+      return;
+    }
+
+    float r, g, b;
+    sampleRgb<Format, Scale>(conversion.plane, conversion.pitch, conversion.sourceWidth, conversion.sourceHeight,
+                             conversion.width, conversion.height, x, y, r, g, b);
+
+    uint8_t *pixel = conversion.output + y * conversion.outputPitch + x * Channels;
+    pixel[0] = static_cast<uint8_t>(fminf(fmaxf(r, 0.0f), 255.0f) + 0.5f);
+    pixel[1] = static_cast<uint8_t>(fminf(fmaxf(g, 0.0f), 255.0f) + 0.5f);
+    pixel[2] = static_cast<uint8_t>(fminf(fmaxf(b, 0.0f), 255.0f) + 0.5f);
+    if (Channels == 4)
+    {
+      pixel[3] = 255;
+    }
+  }
+
+  template <TensorSourceFormat Format, int Scale>
+  static void launchScaled(const FrameConversion &conversion, const dim3 &grid, const dim3 &block, cudaStream_t stream)
+  {
+    if (conversion.channels == 4)
+    {
+      convertResize<Format, Scale, 4><<<grid, block, 0, stream>>>(conversion);
+    }
+    else
+    {
+      convertResize<Format, Scale, 3><<<grid, block, 0, stream>>>(conversion);
+    }
+  }
+
+  int getConversionScale(uint32_t sourceWidth, uint32_t sourceHeight, uint32_t width, uint32_t height)
+  {
+    for (uint32_t scale = 2; scale <= 4; scale *= 2)
+    {
+      if (width > 0 && height > 0 && sourceWidth == scale * width && sourceHeight == scale * height)
+      {
+        return static_cast<int>(scale);
+      }
+    }
+
+    return 0;
+  }
+
+  cudaError_t launchFrameConversion(const FrameConversion &conversion, cudaStream_t stream)
+  {
+    const int scale = getConversionScale(conversion.sourceWidth, conversion.sourceHeight, conversion.width,
+                                         conversion.height);
+    if (scale == 0 || (conversion.channels != 3 && conversion.channels != 4) ||
+        (conversion.format != TENSOR_SOURCE_YUV420 && conversion.format != TENSOR_SOURCE_NV12))
+    {
+      return cudaErrorInvalidValue;
+    }
+
+    const dim3 block(32, 8);
+    const dim3 grid((conversion.width + block.x - 1) / block.x, (conversion.height + block.y - 1) / block.y);
+    if (conversion.format == TENSOR_SOURCE_NV12 && scale == 2)
+    {
+      launchScaled<TENSOR_SOURCE_NV12, 2>(conversion, grid, block, stream);
+    }
+    else if (conversion.format == TENSOR_SOURCE_NV12)
+    {
+      launchScaled<TENSOR_SOURCE_NV12, 4>(conversion, grid, block, stream);
+    }
+    else if (scale == 2)
+    {
+      launchScaled<TENSOR_SOURCE_YUV420, 2>(conversion, grid, block, stream);
+    }
+    else
+    {
+      launchScaled<TENSOR_SOURCE_YUV420, 4>(conversion, grid, block, stream);
+    }
+
+    return cudaGetLastError();
+  }
+
+} // namespace nv
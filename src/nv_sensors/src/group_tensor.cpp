@@ -0,0 +1,306 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "group_tensor.h"
+
+namespace nv
+{
+
+  static const char *getDataTypeName(TensorDataType dataType)
+  {
+    switch (dataType)
+    {
+    case TENSOR_DATA_TYPE_FLOAT32:
+      return "float32";
+    case TENSOR_DATA_TYPE_FLOAT16:
+      return "float16";
+    default:
+      return "uint8";
+    }
+  }
+
+  GroupTensor::~GroupTensor()
+  {
+    release();
+  }
+
+  bool GroupTensor::initialize(const CameraConfig &config, uint32_t batch, const dwImageProperties &imageProperties,
+                               dwContextHandle_t context, uint32_t depth, ros::NodeHandle &nh,
+                               const std::string &topic, const std::string &frameId, const TimeMapper &clock)
+  {
+    if (batch == 0 || batch > MAX_TENSOR_BATCH)
+    {
+      ROS_ERROR("Cannot convert %u cameras into one tensor, at most %u are supported", batch, MAX_TENSOR_BATCH);
+      return false;
+    }
+
+    TensorBatch &kernelBatch = m_kernelBatch;
+    kernelBatch = TensorBatch();
+    switch (imageProperties.format)
+    {
+    case DW_IMAGE_FORMAT_YUV420_UINT8_PLANAR:
+      kernelBatch.format = TENSOR_SOURCE_YUV420;
+      break;
+    case DW_IMAGE_FORMAT_YUV420_UINT8_SEMIPLANAR:
+      kernelBatch.format = TENSOR_SOURCE_NV12;
+      break;
+    case DW_IMAGE_FORMAT_RGBA_UINT8:
+      kernelBatch.format = TENSOR_SOURCE_RGBA;
+      break;
+    default:
+      ROS_ERROR("Native format %d cannot be converted into a tensor", imageProperties.format);
+      return false;
+    }
+
+    kernelBatch.count = batch;
+    kernelBatch.sourceWidth = imageProperties.width;
+    kernelBatch.sourceHeight = imageProperties.height;
+    kernelBatch.width = config.tensorWidth > 0 ? config.tensorWidth : imageProperties.width;
+    kernelBatch.height = config.tensorHeight > 0 ? config.tensorHeight : imageProperties.height;
+    kernelBatch.planar = config.tensorLayout == TENSOR_LAYOUT_NCHW;
+    kernelBatch.dataType = config.tensorDataType;
+    kernelBatch.bgr = config.tensorBgr;
+    // (value / 255 - mean) / std folded into one multiply-add, mean and std are given in tensor channel order
+    for (uint32_t c = 0; c < 3; ++c)
+    {
+      kernelBatch.scale[c] = 1.0f / (255.0f * config.tensorStd[c]);
+      kernelBatch.offset[c] = -config.tensorMean[c] / config.tensorStd[c];
+    }
+
+    const char *dataType = getDataTypeName(config.tensorDataType);
+    const size_t elementSize = config.tensorDataType == TENSOR_DATA_TYPE_FLOAT32   ? 4
+                               : config.tensorDataType == TENSOR_DATA_TYPE_FLOAT16 ? 2
+                                                                                   : 1;
+    m_size = static_cast<size_t>(batch) * 3 * kernelBatch.width * kernelBatch.height * elementSize;
+
+    cudaError_t error = cudaStreamCreateWithFlags(&m_stream, cudaStreamNonBlocking);
+    if (error != cudaSuccess)
+    {
+      ROS_ERROR("Cannot create tensor CUDA stream. Error: %s", cudaGetErrorString(error));
+      m_stream = nullptr;
+      return false;
+    }
+
+    error = cudaMalloc(&m_tensor, m_size);
+    if (error != cudaSuccess)
+    {
+      ROS_ERROR("Cannot allocate %zu byte tensor. Error: %s", m_size, cudaGetErrorString(error));
+      m_tensor = nullptr;
+      release();
+      return false;
+    }
+    kernelBatch.tensor = m_tensor;
+
+    // NvMedia and CPU frames are mapped into CUDA, CUDA frames are read in place
+    if (imageProperties.type != DW_IMAGE_CUDA)
+    {
+      for (uint32_t i = 0; i < batch; ++i)
+      {
+        dwStatus status = dwImageStreamer_initialize(&m_streamer[i], &imageProperties, DW_IMAGE_CUDA, context);
+        if (status != DW_SUCCESS)
+        {
+          ROS_ERROR("Cannot initialize tensor streamer %u. Error: %s", i, dwGetStatusName(status));
+          m_streamer[i] = DW_NULL_HANDLE;
+          release();
+          return false;
+        }
+        dwImageStreamer_setCUDAStream(m_stream, m_streamer[i]);
+      }
+    }
+
+    m_messages.reserve(depth);
+    for (uint32_t i = 0; i < depth; ++i)
+    {
+      nv_sensors::TensorPtr message(new nv_sensors::Tensor);
+      message->header.frame_id = frameId;
+      message->layout = kernelBatch.planar ? "nchw" : "nhwc";
+      message->data_type = dataType;
+      message->channel_order = kernelBatch.bgr ? "bgr" : "rgb";
+      message->mean.assign(config.tensorMean, config.tensorMean + 3);
+      message->std.assign(config.tensorStd, config.tensorStd + 3);
+      if (kernelBatch.planar)
+      {
+        message->shape = {batch, 3, kernelBatch.height, kernelBatch.width};
+      }
+      else
+      {
+        message->shape = {batch, kernelBatch.height, kernelBatch.width, 3};
+      }
+      message->data.resize(m_size);
+
+      error = cudaHostRegister(message->data.data(), m_size, cudaHostRegisterDefault);
+      if (error != cudaSuccess)
+      {
+        ROS_ERROR("Cannot page-lock tensor message %u. Error: %s", i, cudaGetErrorString(error));
+        release();
+        return false;
+      }
+      m_messages.push_back(message);
+    }
+    m_next = 0;
+    m_dropped = 0;
+
+    m_publisher = nh.advertise<nv_sensors::Tensor>(topic + "/tensor", 1);
+    m_batch = batch;
+    m_clock = &clock;
+
+    ROS_INFO("%u cameras being published as %s %s %s tensor of %ux%u on topic /%s/tensor", batch, dataType,
+             kernelBatch.planar ? "nchw" : "nhwc", kernelBatch.bgr ? "bgr" : "rgb", kernelBatch.width,
+             kernelBatch.height, topic.c_str());
+
+    return true;
+  }
+
+  void GroupTensor::release()
+  {
+    m_publisher.shutdown();
+    m_batch = 0;
+
+    // messages still held by roscpp stay valid, they are only no longer page-locked
+    for (const nv_sensors::TensorPtr &message : m_messages)
+    {
+      cudaHostUnregister(message->data.data());
+    }
+    m_messages.clear();
+
+    for (uint32_t i = 0; i < MAX_TENSOR_BATCH; ++i)
+    {
+      if (m_streamer[i])
+      {
+        dwImageStreamer_release(m_streamer[i]);
+        m_streamer[i] = DW_NULL_HANDLE;
+      }
+    }
+
+    if (m_tensor)
+    {
+      cudaFree(m_tensor);
+      m_tensor = nullptr;
+    }
+
+    if (m_stream)
+    {
+      cudaStreamDestroy(m_stream);
+      m_stream = nullptr;
+    }
+  }
+
+  nv_sensors::TensorPtr GroupTensor::acquire()
+  {
+    for (size_t n = 0; n < m_messages.size(); ++n)
+    {
+      const uint32_t i = m_next;
+      m_next = (m_next + 1) % m_messages.size();
+
+      // the pool holds the only reference once roscpp is done with the message
+      if (m_messages[i].use_count() == 1)
+      {
+        return m_messages[i];
+      }
+    }
+
+    return nv_sensors::TensorPtr();
+  }
+
+  void GroupTensor::unmap(uint32_t count)
+  {
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      if (m_mapped[i])
+      {
+        dwImageStreamer_consumerReturn(&m_mapped[i], m_streamer[i]);
+        dwImageStreamer_producerReturn(nullptr, 33000, m_streamer[i]);
+        m_mapped[i] = DW_NULL_HANDLE;
+      }
+    }
+  }
+
+  bool GroupTensor::convert(const dwImageHandle_t *images, dwTime_t timestamp, uint32_t seq)
+  {
+    if (m_publisher.getNumSubscribers() == 0)
+    {
+      return true;
+    }
+
+    nv_sensors::TensorPtr message = acquire();
+    if (!message)
+    {
+      m_dropped++;
+      return true;
+    }
+
+    for (uint32_t i = 0; i < m_batch; ++i)
+    {
+      dwImageHandle_t image = images[i];
+      if (m_streamer[i])
+      {
+        dwStatus status = dwImageStreamer_producerSend(image, m_streamer[i]);
+        if (status == DW_SUCCESS)
+        {
+          status = dwImageStreamer_consumerReceive(&m_mapped[i], 33000, m_streamer[i]);
+          if (status != DW_SUCCESS)
+          {
+            dwImageStreamer_producerReturn(nullptr, 33000, m_streamer[i]);
+            m_mapped[i] = DW_NULL_HANDLE;
+          }
+        }
+        if (status != DW_SUCCESS)
+        {
+          ROS_ERROR("Cannot map camera %u into CUDA for the tensor. Error: %s", i, dwGetStatusName(status));
+          unmap(i);
+          return false;
+        }
+        image = m_mapped[i];
+      }
+
+      dwImageCUDA *cudaImage = nullptr;
+      dwStatus status = dwImage_getCUDA(&cudaImage, image);
+      if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("dwImage_getCUDA() failed. Error: %s", dwGetStatusName(status));
+        unmap(i + 1);
+        return false;
+      }
+
+      const uint32_t planes = m_kernelBatch.format == TENSOR_SOURCE_YUV420 ? 3 : m_kernelBatch.format == TENSOR_SOURCE_NV12 ? 2 : 1;
+      for (uint32_t p = 0; p < planes; ++p)
+      {
+        m_kernelBatch.plane[i][p] = static_cast<const uint8_t *>(cudaImage->dptr[p]);
+        m_kernelBatch.pitch[i][p] = static_cast<uint32_t>(cudaImage->pitch[p]);
+      }
+    }
+
+    // one launch for all cameras and one transfer of the whole tensor
+    cudaError_t error = launchTensorConversion(m_kernelBatch, m_stream);
+    if (error == cudaSuccess)
+    {
+      error = cudaMemcpyAsync(message->data.data(), m_tensor, m_size, cudaMemcpyDeviceToHost, m_stream);
+    }
+    if (error == cudaSuccess)
+    {
+      error = cudaStreamSynchronize(m_stream);
+    }
+    unmap(m_batch);
+
+    if (error != cudaSuccess)
+    {
+      ROS_ERROR("Tensor conversion failed. Error: %s", cudaGetErrorString(error));
+      return false;
+    }
+
+    message->header.stamp = m_clock->toStamp(timestamp);
+    message->header.seq = seq;
+    m_publisher.publish(message);
+
+    return true;
+  }
+
+} // namespace nv
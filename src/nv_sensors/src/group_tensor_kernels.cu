@@ -0,0 +1,141 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "group_tensor_kernels.h"
+#include "conversion_sampling.cuh"
+#include "frame_conversion_kernels.h"
+
+#include <cuda_fp16.h>
+
+namespace nv
+{
+
+  // one thread per tensor pixel, blockIdx.z selects the camera; the source format,
+  // the scale and the element type are fixed per instantiation
+  template <TensorSourceFormat Format, int Scale, TensorDataType DataType>
+  __global__ void convertBatch(TensorBatch batch)
+  {
+    const uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+    const uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+    const uint32_t n = blockIdx.z;
+    if (x >= batch.width || y >= batch.height)
+    {
+      return;
+    }
+
+    float r, g, b;
+    sampleRgb<Format, Scale>(batch.plane[n], batch.pitch[n], batch.sourceWidth, batch.sourceHeight, batch.width,
+                             batch.height, x, y, r, g, b);
+
+    float rgb[3];
+    rgb[batch.bgr ? 2 : 0] = fminf(fmaxf(r, 0.0f), 255.0f);
+    rgb[1] = fminf(fmaxf(g, 0.0f), 255.0f);
+    rgb[batch.bgr ? 0 : 2] = fminf(fmaxf(b, 0.0f), 255.0f);
+
+    const size_t plane = static_cast<size_t>(batch.width) * batch.height;
+    const size_t pixel = static_cast<size_t>(y) * batch.width + x;
+    size_t offset[3];
+    if (batch.planar)
+    {
+      const size_t base = n * 3 * plane + pixel;
+      offset[0] = base;
+      offset[1] = base + plane;
+      offset[2] = base + 2 * plane;
+    }
+    else
+    {
+      const size_t base = (n * plane + pixel) * 3;
+      offset[0] = base;
+      offset[1] = base + 1;
+      offset[2] = base + 2;
+    }
+
+    for (int c = 0; c < 3; ++c)
+    {
+      if (DataType == TENSOR_DATA_TYPE_FLOAT32)
+      {
+        static_cast<float *>(batch.tensor)[offset[c]] = rgb[c] * batch.scale[c] + batch.offset[c];
+      }
+      else if (DataType == TENSOR_DATA_TYPE_FLOAT16)
+      {
+        static_cast<__half *>(batch.tensor)[offset[c]] = __float2half(rgb[c] * batch.scale[c] + batch.offset[c]);
+      }
+      else
+      {
+        static_cast<uint8_t *>(batch.tensor)[offset[c]] = static_cast<uint8_t>(rgb[c] + 0.5f);
+      }
+    }
+  }
+
+  template <TensorSourceFormat Format, int Scale>
+  static void launchScaled(const TensorBatch &batch, const dim3 &grid, const dim3 &block, cudaStream_t stream)
+  {
+    switch (batch.dataType)
+    {
+    case TENSOR_DATA_TYPE_FLOAT32:
+      convertBatch<Format, Scale, TENSOR_DATA_TYPE_FLOAT32><<<grid, block, 0, stream>>>(batch);
+      break;
+    case TENSOR_DATA_TYPE_FLOAT16:
+      convertBatch<Format, Scale, TENSOR_DATA_TYPE_FLOAT16><<<grid, block, 0, stream>>>(batch);
+      break;
+    default:
+      convertBatch<Format, Scale, TENSOR_DATA_TYPE_UINT8><<<grid, block, 0, stream>>>(batch);
+      break;
+    }
+  }
+
+  template <TensorSourceFormat Format>
+  static void launchFormat(const TensorBatch &batch, int scale, const dim3 &grid, const dim3 &block,
+                           cudaStream_t stream)
+  {
+    if (scale == 2)
+    {
+      launchScaled<Format, 2>(batch, grid, block, stream);
+    }
+    else if (scale == 4)
+    {
+      launchScaled<Format, 4>(batch, grid, block, stream);
+    }
+    else
+    {
+      launchScaled<Format, 0>(batch, grid, block, stream);
+    }
+  }
+
+  cudaError_t launchTensorConversion(const TensorBatch &batch, cudaStream_t stream, bool specialized)
+  {
+    if (batch.count == 0 || batch.count > MAX_TENSOR_BATCH)
+    {
+      return cudaErrorInvalidValue;
+    }
+
+    // 1/2 and 1/4 of the frames read fixed pixels, any other size is sampled bilinearly
+    const int scale =
+        specialized ? getConversionScale(batch.sourceWidth, batch.sourceHeight, batch.width, batch.height) : 0;
+    const dim3 block(32, 8);
+    const dim3 grid((batch.width + block.x - 1) / block.x, (batch.height + block.y - 1) / block.y, batch.count);
+    switch (batch.format)
+    {
+    case TENSOR_SOURCE_NV12:
+      launchFormat<TENSOR_SOURCE_NV12>(batch, scale, grid, block, stream);
+      break;
+    case TENSOR_SOURCE_RGBA:
+      launchFormat<TENSOR_SOURCE_RGBA>(batch, scale, grid, block, stream);
+      break;
+    default:
+      launchFormat<TENSOR_SOURCE_YUV420>(batch, scale, grid, block, stream);
+      break;
+    }
+
+    return cudaGetLastError();
+  }
+
+} // namespace nv
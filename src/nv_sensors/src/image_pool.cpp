@@ -0,0 +1,32 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "image_pool.h"
+
+namespace nv
+{
+
+  void ImagePool::initialize(uint32_t depth, const std::string &encoding, uint32_t width, uint32_t height,
+                             uint32_t step, size_t size, const std::string &frameId)
+  {
+    sensor_msgs::Image prototype;
+    prototype.header.frame_id = frameId;
+    prototype.encoding = encoding;
+    prototype.is_bigendian = 0;
+    prototype.width = width;
+    prototype.height = height;
+    prototype.step = step;
+    prototype.data.resize(size);
+
+    MessagePool<sensor_msgs::Image>::initialize(depth, prototype);
+  }
+
+} // namespace nv
@@ -0,0 +1,228 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "imu.h"
+
+namespace nv
+{
+
+  // timeout of one frame read
+  static const dwTime_t READ_TIMEOUT_US = 100000;
+
+  static const uint32_t ACCELERATION_FLAGS = DW_IMU_ACCELERATION_X | DW_IMU_ACCELERATION_Y | DW_IMU_ACCELERATION_Z;
+  static const uint32_t TURNRATE_FLAGS = DW_IMU_TURNRATE_X | DW_IMU_TURNRATE_Y | DW_IMU_TURNRATE_Z;
+
+  SensorIMU::~SensorIMU()
+  {
+    release();
+  }
+
+  bool SensorIMU::start(dwSensorParams params)
+  {
+    if (m_run)
+    {
+      ROS_WARN("IMU sensor already running");
+      return false;
+    }
+
+    m_privateNodeHandle.param("imu_frame_id", m_frameId, std::string("imu"));
+    if (!loadCommonOptions())
+    {
+      return false;
+    }
+
+    ROS_INFO("Starting IMU sensor %s %s", params.protocol, params.parameters ? params.parameters : "");
+    dwStatus status = dwSAL_createSensor(&m_imu, params, m_hal);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot create IMU sensor %s. Error: %s", params.protocol, dwGetStatusName(status));
+      m_imu = DW_NULL_HANDLE;
+      return false;
+    }
+
+    // a few frames are buffered, a late subscriber does not hold back the capture stage
+    m_imuPub = m_nodeHandle.advertise<sensor_msgs::Imu>("imuData", 16);
+    ROS_INFO("IMU data being published on topic /imuData");
+
+    status = dwSensor_start(m_imu);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot start IMU sensor. Error: %s", dwGetStatusName(status));
+      m_imuPub.shutdown();
+      dwSAL_releaseSensor(m_imu);
+      m_imu = DW_NULL_HANDLE;
+      return false;
+    }
+
+    m_run = true;
+    m_captureThread = std::thread(&SensorIMU::run_capture, this);
+    applyThreadPolicy(m_captureThread, m_capturePolicy, m_threadSlot, "nv_imu_cap");
+    startTimers();
+
+    return true;
+  }
+
+  bool SensorIMU::stop()
+  {
+    if (!m_run)
+    {
+      ROS_WARN("IMU sensor not running");
+      return false;
+    }
+
+    m_run = false;
+    stopTimers();
+    if (m_captureThread.joinable())
+    {
+      m_captureThread.join();
+    }
+
+    dwSensor_stop(m_imu);
+    dwSAL_releaseSensor(m_imu);
+    m_imu = DW_NULL_HANDLE;
+    m_imuPub.shutdown();
+    ROS_INFO("IMU read %lu frames (incomplete %lu), published %lu", m_counters.frames.load(),
+             m_counters.incomplete.load(), m_counters.published.load());
+
+    return true;
+  }
+
+  void SensorIMU::release()
+  {
+    if (m_run)
+    {
+      stop();
+    }
+  }
+
+  bool SensorIMU::fillMessage(const dwIMUFrame &frame, sensor_msgs::Imu &message) const
+  {
+    if ((frame.flags & ACCELERATION_FLAGS) != ACCELERATION_FLAGS || (frame.flags & TURNRATE_FLAGS) != TURNRATE_FLAGS)
+    {
+      return false;
+    }
+
+    message.header.frame_id = m_frameId;
+    message.header.stamp = m_clock.toStamp(frame.timestamp_us);
+
+    message.orientation_covariance.fill(0.0);
+    if (frame.flags & DW_IMU_QUATERNION)
+    {
+      message.orientation.x = frame.orientationQuaternion.x;
+      message.orientation.y = frame.orientationQuaternion.y;
+      message.orientation.z = frame.orientationQuaternion.z;
+      message.orientation.w = frame.orientationQuaternion.w;
+    }
+    else
+    {
+      message.orientation.x = 0.0;
+      message.orientation.y = 0.0;
+      message.orientation.z = 0.0;
+      message.orientation.w = 1.0;
+      message.orientation_covariance[0] = -1.0;
+    }
+
+    // rad/s and m/s^2 as in sensor_msgs/Imu, the covariances are not reported by the sensor
+    message.angular_velocity.x = frame.turnrate[0];
+    message.angular_velocity.y = frame.turnrate[1];
+    message.angular_velocity.z = frame.turnrate[2];
+    message.angular_velocity_covariance.fill(0.0);
+    message.linear_acceleration.x = frame.acceleration[0];
+    message.linear_acceleration.y = frame.acceleration[1];
+    message.linear_acceleration.z = frame.acceleration[2];
+    message.linear_acceleration_covariance.fill(0.0);
+
+    return true;
+  }
+
+  void SensorIMU::run_capture()
+  {
+    while (m_run)
+    {
+      dwIMUFrame frame;
+      const PipelineClock::time_point start = PipelineClock::now();
+      dwStatus status = dwSensorIMU_readFrame(&frame, READ_TIMEOUT_US, m_imu);
+      if (status == DW_END_OF_STREAM)
+      {
+        // a recording is replayed from the start
+        ROS_INFO("IMU sensor end of stream reached, restarting");
+        dwSensor_reset(m_imu);
+        continue;
+      }
+      else if (status == DW_TIME_OUT || status == DW_NOT_READY)
+      {
+        m_counters.missed++;
+        continue;
+      }
+      else if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("IMU sensor readFrame failed. Error: %s", dwGetStatusName(status));
+        break;
+      }
+      m_stats.read.record(start);
+      m_counters.frames++;
+
+      // the heading and magnetometer frames of some devices carry no motion
+      sensor_msgs::ImuPtr message(new sensor_msgs::Imu);
+      if (!fillMessage(frame, *message))
+      {
+        m_counters.incomplete++;
+        continue;
+      }
+      message->header.seq = static_cast<uint32_t>(m_counters.published.load());
+
+      const PipelineClock::time_point publishStart = PipelineClock::now();
+      m_imuPub.publish(message);
+      m_stats.publish.record(publishStart);
+      m_counters.published++;
+
+      dwTime_t now;
+      if (dwContext_getCurrentTime(&now, m_sdk) == DW_SUCCESS)
+      {
+        m_stats.latency.record(now - frame.timestamp_us);
+      }
+    }
+  }
+
+  void SensorIMU::collectStats(diagnostic_msgs::DiagnosticArray &diagnostics)
+  {
+    const PipelineClock::time_point now = PipelineClock::now();
+    const double elapsed = std::chrono::duration<double>(now - m_statsTime).count();
+    m_statsTime = now;
+
+    diagnostics.header.stamp = ros::Time::now();
+    diagnostics.status.clear();
+    if (elapsed <= 0.0)
+    {
+      return;
+    }
+
+    const uint64_t frames = m_counters.frames.load();
+    const double rate = (frames - m_statsFrames) / elapsed;
+    m_statsFrames = frames;
+
+    diagnostic_msgs::DiagnosticStatus imu;
+    imu.name = "nv_sensors: imu";
+    imu.hardware_id = m_frameId;
+    imu.level = rate > 0.0 ? diagnostic_msgs::DiagnosticStatus::OK : diagnostic_msgs::DiagnosticStatus::WARN;
+    imu.message = formatRate(rate) + " Hz";
+    addValue(imu, "rate", formatRate(rate));
+    addValue(imu, "frames", std::to_string(frames));
+    addValue(imu, "missed reads", std::to_string(m_counters.missed.load()));
+    addValue(imu, "incomplete", std::to_string(m_counters.incomplete.load()));
+    addValue(imu, "published", std::to_string(m_counters.published.load()));
+    addStage(imu, "read", m_stats.read);
+    addStage(imu, "publish", m_stats.publish);
+    addStage(imu, "latency", m_stats.latency);
+    diagnostics.status.push_back(imu);
+  }
+
+} // namespace nv
@@ -0,0 +1,326 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "lidar.h"
+
+#include <sensor_msgs/PointField.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace nv
+{
+
+  // the cloud holds the decoded points as delivered, x y z intensity
+  static_assert(sizeof(dwLidarPointXYZI) == 4 * sizeof(float), "dwLidarPointXYZI is expected to be 4 floats");
+
+  // timeout of one packet read
+  static const dwTime_t READ_TIMEOUT_US = 100000;
+
+  static sensor_msgs::PointField makeField(const std::string &name, uint32_t offset)
+  {
+    sensor_msgs::PointField field;
+    field.name = name;
+    field.offset = offset;
+    field.datatype = sensor_msgs::PointField::FLOAT32;
+    field.count = 1;
+    return field;
+  }
+
+  SensorLidar::~SensorLidar()
+  {
+    release();
+  }
+
+  bool SensorLidar::start(dwSensorParams params)
+  {
+    if (m_run)
+    {
+      ROS_WARN("LIDAR sensor already running");
+      return false;
+    }
+
+    int poolDepth = 4;
+    int ringDepth = 2;
+    m_privateNodeHandle.param("pool_depth", poolDepth, 4);
+    m_privateNodeHandle.param("ring_depth", ringDepth, 2);
+    m_privateNodeHandle.param("lidar_frame_id", m_frameId, std::string("lidar"));
+    if (!loadCommonOptions())
+    {
+      return false;
+    }
+
+    ROS_INFO("Starting LIDAR sensor %s %s", params.protocol, params.parameters ? params.parameters : "");
+    dwStatus status = dwSAL_createSensor(&m_lidar, params, m_hal);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot create LIDAR sensor %s. Error: %s", params.protocol, dwGetStatusName(status));
+      m_lidar = DW_NULL_HANDLE;
+      return false;
+    }
+
+    status = dwSensorLidar_getProperties(&m_properties, m_lidar);
+    if (status != DW_SUCCESS || m_properties.pointsPerSpin == 0)
+    {
+      ROS_ERROR("Cannot get properties of LIDAR sensor. Error: %s", dwGetStatusName(status));
+      releaseSensor();
+      return false;
+    }
+
+    // a spin may end a packet late
+    m_capacity = m_properties.pointsPerSpin + m_properties.pointsPerPacket;
+    sensor_msgs::PointCloud2 prototype;
+    prototype.header.frame_id = m_frameId;
+    prototype.height = 1;
+    prototype.width = 0;
+    prototype.fields = {makeField("x", 0), makeField("y", 4), makeField("z", 8), makeField("intensity", 12)};
+    prototype.is_bigendian = false;
+    prototype.point_step = sizeof(dwLidarPointXYZI);
+    prototype.row_step = 0;
+    prototype.is_dense = true;
+    prototype.data.resize(static_cast<size_t>(m_capacity) * sizeof(dwLidarPointXYZI));
+    m_pool.initialize(static_cast<uint32_t>(std::max(poolDepth, 1)), prototype);
+    m_ring.initialize(static_cast<uint32_t>(std::max(ringDepth, 1)));
+    ROS_INFO("LIDAR %s: %.1f Hz, %u points per spin, %u pooled messages of %u points", m_properties.deviceString,
+             m_properties.spinFrequency, m_properties.pointsPerSpin, m_pool.getDepth(), m_capacity);
+
+    m_cloudPub = m_nodeHandle.advertise<sensor_msgs::PointCloud2>("lidarData", 1);
+    ROS_INFO("LIDAR data being published on topic /lidarData");
+
+    status = dwSensor_start(m_lidar);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot start LIDAR sensor. Error: %s", dwGetStatusName(status));
+      releaseSensor();
+      return false;
+    }
+
+    m_cloud.reset();
+    m_spinStarted = false;
+    m_run = true;
+    m_captureThread = std::thread(&SensorLidar::run_capture, this);
+    applyThreadPolicy(m_captureThread, m_capturePolicy, m_threadSlot, "nv_lidar_cap");
+    m_publishThread = std::thread(&SensorLidar::run_publish, this);
+    applyThreadPolicy(m_publishThread, m_publishPolicy, m_threadSlot, "nv_lidar_pub");
+    startTimers();
+
+    return true;
+  }
+
+  bool SensorLidar::stop()
+  {
+    if (!m_run)
+    {
+      ROS_WARN("LIDAR sensor not running");
+      return false;
+    }
+
+    m_run = false;
+    stopTimers();
+    m_ring.wake();
+    if (m_captureThread.joinable())
+    {
+      m_captureThread.join();
+    }
+    if (m_publishThread.joinable())
+    {
+      m_publishThread.join();
+    }
+
+    dwSensor_stop(m_lidar);
+    releaseSensor();
+    ROS_INFO("LIDAR read %lu packets, %lu spins (no free message %lu, publish ring dropped %lu), published %lu",
+             m_counters.packets.load(), m_counters.spins.load(), m_counters.noFreeMessage.load(), m_ring.getDropped(),
+             m_counters.published.load());
+
+    return true;
+  }
+
+  void SensorLidar::release()
+  {
+    if (m_run)
+    {
+      stop();
+    }
+  }
+
+  void SensorLidar::releaseSensor()
+  {
+    sensor_msgs::PointCloud2 *queued;
+    while (m_ring.pop(queued))
+    {
+      m_pool.recycle(queued);
+    }
+    m_cloud.reset();
+    m_pool.release();
+    m_cloudPub.shutdown();
+
+    if (m_lidar)
+    {
+      dwSAL_releaseSensor(m_lidar);
+      m_lidar = DW_NULL_HANDLE;
+    }
+  }
+
+  void SensorLidar::run_capture()
+  {
+    while (m_run)
+    {
+      const dwLidarDecodedPacket *packet;
+      const PipelineClock::time_point start = PipelineClock::now();
+      dwStatus status = dwSensorLidar_readPacket(&packet, READ_TIMEOUT_US, m_lidar);
+      if (status == DW_END_OF_STREAM)
+      {
+        // a recording is replayed from the start
+        ROS_INFO("LIDAR sensor end of stream reached, restarting");
+        dwSensor_reset(m_lidar);
+        m_spinStarted = false;
+        continue;
+      }
+      else if (status == DW_TIME_OUT || status == DW_NOT_READY)
+      {
+        m_counters.missed++;
+        continue;
+      }
+      else if (status != DW_SUCCESS)
+      {
+        ROS_ERROR("LIDAR sensor readPacket failed. Error: %s", dwGetStatusName(status));
+        break;
+      }
+      m_stats.read.record(start);
+      m_counters.packets++;
+
+      // the first packet of a spin takes a message and stamps it
+      if (!m_spinStarted)
+      {
+        m_spinStarted = true;
+        m_spinStamp = packet->hostTimestamp;
+        m_points = 0;
+        m_cloud = m_pool.acquire();
+        if (m_cloud)
+        {
+          // back to full size within the allocated capacity, the buffer is not reallocated
+          m_cloud->data.resize(static_cast<size_t>(m_capacity) * sizeof(dwLidarPointXYZI));
+        }
+        else
+        {
+          ROS_WARN_THROTTLE(1.0, "LIDAR all %u pooled messages in flight, dropping spin", m_pool.getDepth());
+          m_counters.noFreeMessage++;
+        }
+      }
+
+      if (m_cloud)
+      {
+        const uint32_t count = std::min(packet->nPoints, m_capacity - m_points);
+        memcpy(m_cloud->data.data() + static_cast<size_t>(m_points) * sizeof(dwLidarPointXYZI), packet->pointsXYZI,
+               static_cast<size_t>(count) * sizeof(dwLidarPointXYZI));
+        m_points += count;
+        m_counters.truncated += packet->nPoints - count;
+      }
+
+      const bool scanComplete = packet->scanComplete;
+      dwSensorLidar_returnPacket(packet, m_lidar);
+      if (scanComplete)
+      {
+        completeSpin();
+      }
+    }
+  }
+
+  void SensorLidar::completeSpin()
+  {
+    m_spinStarted = false;
+    m_counters.spins++;
+    if (!m_cloud)
+    {
+      return;
+    }
+
+    m_cloud->header.stamp = m_clock.toStamp(m_spinStamp);
+    m_cloud->header.seq = static_cast<uint32_t>(m_counters.spins.load() - 1);
+    m_cloud->width = m_points;
+    m_cloud->row_step = m_points * m_cloud->point_step;
+    m_cloud->data.resize(m_cloud->row_step);
+
+    // a full ring hands the oldest spin back to the pool
+    sensor_msgs::PointCloud2 *evicted;
+    if (m_ring.push(m_cloud.get(), evicted))
+    {
+      m_pool.recycle(evicted);
+    }
+    m_cloud.reset();
+  }
+
+  void SensorLidar::run_publish()
+  {
+    while (m_run)
+    {
+      sensor_msgs::PointCloud2 *queued;
+      if (!m_ring.waitPop(queued, READ_TIMEOUT_US))
+      {
+        continue;
+      }
+
+      sensor_msgs::PointCloud2Ptr cloud = m_pool.share(queued);
+      const PipelineClock::time_point start = PipelineClock::now();
+      m_cloudPub.publish(cloud);
+      m_stats.publish.record(start);
+      m_counters.published++;
+
+      // host timestamps are in the time base of the Driveworks context
+      dwTime_t now;
+      if (dwContext_getCurrentTime(&now, m_sdk) == DW_SUCCESS)
+      {
+        m_stats.latency.record(now - m_clock.toSensorTime(cloud->header.stamp));
+      }
+
+      // free once roscpp dropped its references
+      m_pool.recycle(queued);
+    }
+  }
+
+  void SensorLidar::collectStats(diagnostic_msgs::DiagnosticArray &diagnostics)
+  {
+    const PipelineClock::time_point now = PipelineClock::now();
+    const double elapsed = std::chrono::duration<double>(now - m_statsTime).count();
+    m_statsTime = now;
+
+    diagnostics.header.stamp = ros::Time::now();
+    diagnostics.status.clear();
+    if (elapsed <= 0.0)
+    {
+      return;
+    }
+
+    const uint64_t spins = m_counters.spins.load();
+    const double spinRate = (spins - m_statsSpins) / elapsed;
+    m_statsSpins = spins;
+
+    diagnostic_msgs::DiagnosticStatus lidar;
+    lidar.name = "nv_sensors: lidar";
+    lidar.hardware_id = m_frameId;
+    lidar.level = spinRate > 0.0 ? diagnostic_msgs::DiagnosticStatus::OK : diagnostic_msgs::DiagnosticStatus::WARN;
+    lidar.message = formatRate(spinRate) + " spins per second";
+    addValue(lidar, "spin rate", formatRate(spinRate));
+    addValue(lidar, "packets", std::to_string(m_counters.packets.load()));
+    addValue(lidar, "missed reads", std::to_string(m_counters.missed.load()));
+    addValue(lidar, "spins", std::to_string(spins));
+    addValue(lidar, "no free message", std::to_string(m_counters.noFreeMessage.load()));
+    addValue(lidar, "truncated points", std::to_string(m_counters.truncated.load()));
+    addValue(lidar, "publish ring dropped", std::to_string(m_ring.getDropped()));
+    addValue(lidar, "published", std::to_string(m_counters.published.load()));
+    addStage(lidar, "read", m_stats.read);
+    addStage(lidar, "publish", m_stats.publish);
+    addStage(lidar, "latency", m_stats.latency);
+    diagnostics.status.push_back(lidar);
+  }
+
+} // namespace nv
@@ -0,0 +1,602 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Offline benchmark of the capture pipeline. Replays a recording through the
+ * Driveworks virtual camera once per output mode and prints one JSON object
+ * per mode: frame rates, stage durations, CPU usage and heap allocations per
+ * frame. Needs a running roscore since the outputs are advertised as usual.
+ * --kernels times the fused conversion kernels against the paths they
+ * replace on a synthetic frame, without a recording.
+ *
+ *   nv_sensors_bench --video <file.h264|.raw|.lraw> [--duration <s>] [--rate <Hz>]
+ *                    [--modes <mode,...>] [--kernels <iterations>] [--output <file.jsonl>]
+ */
+
+#include "camera.h"
+#include "frame_conversion_kernels.h"
+#include "group_tensor_kernels.h"
+#include "nvcommon.h"
+
+#include <ros/ros.h>
+
+//dw core
+#include <dw/core/Context.h>
+#include <dw/core/VersionCurrent.h>
+
+#include <cuda_fp16.h>
+#include <cuda_runtime.h>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace nv;
+
+// heap allocations of the whole process, the pipeline should not allocate per frame
+static std::atomic<uint64_t> allocationCount{0};
+
+void *operator new(size_t size)
+{
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  void *memory = malloc(size ? size : 1);
+  if (!memory)
+  {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void operator delete(void *memory) noexcept
+{
+  free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+  free(memory);
+}
+
+// camera parameters appended to the recording per output mode
+struct BenchMode
+{
+  const char *name;
+  const char *params;
+};
+
+static const BenchMode benchModes[] = {
+    {"rgba-resize", ""},
+    {"rgba-full", "output=full"},
+    {"native-resize", "output-encoding=native"},
+    {"native-full", "output-encoding=native,output=full"},
+    {"cuda-resize", "output-domain=cuda"},
+    {"cuda-full", "output-domain=cuda,output=full"},
+};
+
+// format pairs of the kernel benchmark, a source of the SF3324 size
+struct KernelCase
+{
+  const char *name;
+  dwImageFormat source;
+  // output frame format, DW_IMAGE_FORMAT_UNKNOWN for an FP16 NCHW tensor
+  dwImageFormat output;
+  uint32_t scale;
+};
+
+static const KernelCase kernelCases[] = {
+    {"yuv420-rgba8-1/2", DW_IMAGE_FORMAT_YUV420_UINT8_PLANAR, DW_IMAGE_FORMAT_RGBA_UINT8, 2},
+    {"yuv420-rgb8-1/2", DW_IMAGE_FORMAT_YUV420_UINT8_PLANAR, DW_IMAGE_FORMAT_RGB_UINT8, 2},
+    {"nv12-rgba8-1/4", DW_IMAGE_FORMAT_YUV420_UINT8_SEMIPLANAR, DW_IMAGE_FORMAT_RGBA_UINT8, 4},
+    {"nv12-fp16-nchw-1/4", DW_IMAGE_FORMAT_YUV420_UINT8_SEMIPLANAR, DW_IMAGE_FORMAT_UNKNOWN, 4},
+};
+
+static const uint32_t KERNEL_WIDTH = 1920;
+static const uint32_t KERNEL_HEIGHT = 1208;
+
+static double getCpuSeconds()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+static std::string quote(const std::string &text)
+{
+  std::string quoted = "\"";
+  for (char c : text)
+  {
+    if (c == '"' || c == '\\')
+    {
+      quoted += '\\';
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+// a status as JSON object, numeric values are written as numbers
+static std::string toJson(const diagnostic_msgs::DiagnosticStatus &status)
+{
+  std::string json = "{\"name\":" + quote(status.name);
+  for (const diagnostic_msgs::KeyValue &value : status.values)
+  {
+    char *end = nullptr;
+    strtod(value.value.c_str(), &end);
+    bool numeric = !value.value.empty() && *end == '\0';
+    json += "," + quote(value.key) + ":" + (numeric ? value.value : quote(value.value));
+  }
+  return json + "}";
+}
+
+// mean GPU time of one pass in us on the default stream, after one pass of warm-up
+static double timePasses(uint32_t iterations, const std::function<bool()> &pass)
+{
+  cudaEvent_t start, stop;
+  cudaEventCreate(&start);
+  cudaEventCreate(&stop);
+
+  bool ok = pass();
+  cudaEventRecord(start, nullptr);
+  for (uint32_t i = 0; ok && i < iterations; ++i)
+  {
+    ok = pass();
+  }
+  cudaEventRecord(stop, nullptr);
+  cudaEventSynchronize(stop);
+
+  float ms = 0.0f;
+  cudaEventElapsedTime(&ms, start, stop);
+  cudaEventDestroy(start);
+  cudaEventDestroy(stop);
+
+  return ok ? 1000.0 * ms / iterations : -1.0;
+}
+
+static dwImageHandle_t createCudaImage(uint32_t width, uint32_t height, dwImageFormat format, dwContextHandle_t sdk)
+{
+  dwImageProperties properties{};
+  properties.type = DW_IMAGE_CUDA;
+  properties.width = width;
+  properties.height = height;
+  properties.format = format;
+
+  dwImageHandle_t image = DW_NULL_HANDLE;
+  dwStatus status = dwImage_create(&image, properties, sdk);
+  if (status != DW_SUCCESS)
+  {
+    ROS_ERROR("Cannot create %ux%u CUDA image. Error: %s", width, height, dwGetStatusName(status));
+    return DW_NULL_HANDLE;
+  }
+  return image;
+}
+
+// a fixed pattern in every plane, both paths read the same frame
+static void fillPattern(const dwImageCUDA *frame)
+{
+  const bool semiPlanar = frame->prop.format == DW_IMAGE_FORMAT_YUV420_UINT8_SEMIPLANAR;
+  for (uint32_t p = 0; p < (semiPlanar ? 2u : 3u); ++p)
+  {
+    const uint32_t bytes = p == 0 || semiPlanar ? frame->prop.width : frame->prop.width / 2;
+    const uint32_t rows = p == 0 ? frame->prop.height : frame->prop.height / 2;
+    std::vector<uint8_t> pattern(static_cast<size_t>(bytes) * rows);
+    for (uint32_t y = 0; y < rows; ++y)
+    {
+      for (uint32_t x = 0; x < bytes; ++x)
+      {
+        pattern[static_cast<size_t>(y) * bytes + x] = static_cast<uint8_t>(x * 7 + y * 3 + p * 64);
+      }
+    }
+    cudaMemcpy2DAsync(frame->dptr[p], frame->pitch[p], pattern.data(), bytes, bytes, rows, cudaMemcpyHostToDevice,
+                      nullptr);
+  }
+  cudaStreamSynchronize(nullptr);
+}
+
+// largest difference of the 8 bit samples of two interleaved frames of one size
+static int compareFrames(const dwImageCUDA *a, const dwImageCUDA *b, uint32_t channels)
+{
+  const size_t bytes = static_cast<size_t>(a->prop.width) * channels;
+  std::vector<uint8_t> hostA(bytes * a->prop.height);
+  std::vector<uint8_t> hostB(bytes * a->prop.height);
+  cudaMemcpy2DAsync(hostA.data(), bytes, a->dptr[0], a->pitch[0], bytes, a->prop.height, cudaMemcpyDeviceToHost,
+                    nullptr);
+  cudaMemcpy2DAsync(hostB.data(), bytes, b->dptr[0], b->pitch[0], bytes, a->prop.height, cudaMemcpyDeviceToHost,
+                    nullptr);
+  cudaStreamSynchronize(nullptr);
+
+  int difference = 0;
+  for (size_t i = 0; i < hostA.size(); ++i)
+  {
+    difference = std::max(difference, std::abs(static_cast<int>(hostA[i]) - static_cast<int>(hostB[i])));
+  }
+  return difference;
+}
+
+static void printKernelCase(FILE *output, const KernelCase &kernel, uint32_t iterations, const char *baseline,
+                            double baselineUs, double fusedUs, double difference)
+{
+  fprintf(output, "{\"kernel\":%s,\"source\":\"%ux%u\",\"size\":\"%ux%u\",\"iterations\":%u,\"baseline\":%s,"
+                  "\"baseline_us\":%.1f,\"fused_us\":%.1f,\"speedup\":%.2f,\"max_difference\":%g}\n",
+          quote(kernel.name).c_str(), KERNEL_WIDTH, KERNEL_HEIGHT, KERNEL_WIDTH / kernel.scale,
+          KERNEL_HEIGHT / kernel.scale, iterations, quote(baseline).c_str(), baselineUs, fusedUs,
+          fusedUs > 0.0 ? baselineUs / fusedUs : 0.0, difference);
+  fflush(output);
+}
+
+// dwImage_copyConvert() to full size and dwImageTransformation_copy() against one fused kernel
+static bool benchFrameCase(const KernelCase &kernel, uint32_t iterations, dwContextHandle_t sdk,
+                           dwImageTransformationHandle_t transformation, FILE *output)
+{
+  const uint32_t width = KERNEL_WIDTH / kernel.scale;
+  const uint32_t height = KERNEL_HEIGHT / kernel.scale;
+  dwImageHandle_t images[4] = {createCudaImage(KERNEL_WIDTH, KERNEL_HEIGHT, kernel.source, sdk),
+                               createCudaImage(KERNEL_WIDTH, KERNEL_HEIGHT, kernel.output, sdk),
+                               createCudaImage(width, height, kernel.output, sdk),
+                               createCudaImage(width, height, kernel.output, sdk)};
+  dwImageHandle_t source = images[0];
+  dwImageHandle_t converted = images[1];
+  dwImageHandle_t resized = images[2];
+  dwImageHandle_t fused = images[3];
+
+  bool ok = source && converted && resized && fused;
+  dwImageCUDA *sourceCUDA = nullptr;
+  dwImageCUDA *resizedCUDA = nullptr;
+  dwImageCUDA *fusedCUDA = nullptr;
+  ok = ok && dwImage_getCUDA(&sourceCUDA, source) == DW_SUCCESS &&
+       dwImage_getCUDA(&resizedCUDA, resized) == DW_SUCCESS && dwImage_getCUDA(&fusedCUDA, fused) == DW_SUCCESS;
+  if (ok)
+  {
+    fillPattern(sourceCUDA);
+
+    const dwRect fullRect = {0, 0, static_cast<int32_t>(KERNEL_WIDTH), static_cast<int32_t>(KERNEL_HEIGHT)};
+    const dwRect targetRect = {0, 0, static_cast<int32_t>(width), static_cast<int32_t>(height)};
+    const double baselineUs = timePasses(iterations, [&]() {
+      return dwImage_copyConvert(converted, source, sdk) == DW_SUCCESS &&
+             dwImageTransformation_copy(resized, converted, &targetRect, &fullRect, transformation) == DW_SUCCESS;
+    });
+
+    FrameConversion conversion{};
+    for (uint32_t p = 0; p < 3; ++p)
+    {
+      conversion.plane[p] = static_cast<const uint8_t *>(sourceCUDA->dptr[p]);
+      conversion.pitch[p] = static_cast<uint32_t>(sourceCUDA->pitch[p]);
+    }
+    conversion.format =
+        kernel.source == DW_IMAGE_FORMAT_YUV420_UINT8_SEMIPLANAR ? TENSOR_SOURCE_NV12 : TENSOR_SOURCE_YUV420;
+    conversion.sourceWidth = KERNEL_WIDTH;
+    conversion.sourceHeight = KERNEL_HEIGHT;
+    conversion.output = static_cast<uint8_t *>(fusedCUDA->dptr[0]);
+    conversion.outputPitch = static_cast<uint32_t>(fusedCUDA->pitch[0]);
+    conversion.channels = kernel.output == DW_IMAGE_FORMAT_RGB_UINT8 ? 3 : 4;
+    conversion.width = width;
+    conversion.height = height;
+    const double fusedUs =
+        timePasses(iterations, [&]() { return launchFrameConversion(conversion, nullptr) == cudaSuccess; });
+
+    ok = baselineUs >= 0.0 && fusedUs >= 0.0;
+    if (ok)
+    {
+      printKernelCase(output, kernel, iterations, "copyConvert+transformation", baselineUs, fusedUs,
+                      compareFrames(resizedCUDA, fusedCUDA, conversion.channels));
+    }
+  }
+
+  for (dwImageHandle_t image : images)
+  {
+    if (image)
+    {
+      dwImage_destroy(image);
+    }
+  }
+  return ok;
+}
+
+// the bilinear tensor kernel against the one specialized for the scale
+static bool benchTensorCase(const KernelCase &kernel, uint32_t iterations, dwContextHandle_t sdk, FILE *output)
+{
+  const uint32_t width = KERNEL_WIDTH / kernel.scale;
+  const uint32_t height = KERNEL_HEIGHT / kernel.scale;
+  const size_t elements = static_cast<size_t>(3) * width * height;
+  dwImageHandle_t source = createCudaImage(KERNEL_WIDTH, KERNEL_HEIGHT, kernel.source, sdk);
+  void *tensors[2] = {nullptr, nullptr};
+
+  dwImageCUDA *sourceCUDA = nullptr;
+  bool ok = source && dwImage_getCUDA(&sourceCUDA, source) == DW_SUCCESS &&
+            cudaMalloc(&tensors[0], elements * sizeof(__half)) == cudaSuccess &&
+            cudaMalloc(&tensors[1], elements * sizeof(__half)) == cudaSuccess;
+  if (ok)
+  {
+    fillPattern(sourceCUDA);
+
+    TensorBatch batch{};
+    for (uint32_t p = 0; p < 3; ++p)
+    {
+      batch.plane[0][p] = static_cast<const uint8_t *>(sourceCUDA->dptr[p]);
+      batch.pitch[0][p] = static_cast<uint32_t>(sourceCUDA->pitch[p]);
+    }
+    batch.count = 1;
+    batch.format =
+        kernel.source == DW_IMAGE_FORMAT_YUV420_UINT8_SEMIPLANAR ? TENSOR_SOURCE_NV12 : TENSOR_SOURCE_YUV420;
+    batch.sourceWidth = KERNEL_WIDTH;
+    batch.sourceHeight = KERNEL_HEIGHT;
+    batch.width = width;
+    batch.height = height;
+    batch.planar = true;
+    batch.dataType = TENSOR_DATA_TYPE_FLOAT16;
+    for (uint32_t c = 0; c < 3; ++c)
+    {
+      batch.scale[c] = 1.0f / 255.0f;
+      batch.offset[c] = 0.0f;
+    }
+    batch.bgr = false;
+
+    TensorBatch specialized = batch;
+    batch.tensor = tensors[0];
+    specialized.tensor = tensors[1];
+    const double baselineUs =
+        timePasses(iterations, [&]() { return launchTensorConversion(batch, nullptr, false) == cudaSuccess; });
+    const double fusedUs =
+        timePasses(iterations, [&]() { return launchTensorConversion(specialized, nullptr) == cudaSuccess; });
+
+    ok = baselineUs >= 0.0 && fusedUs >= 0.0;
+    if (ok)
+    {
+      std::vector<__half> hostA(elements);
+      std::vector<__half> hostB(elements);
+      cudaMemcpyAsync(hostA.data(), tensors[0], elements * sizeof(__half), cudaMemcpyDeviceToHost, nullptr);
+      cudaMemcpyAsync(hostB.data(), tensors[1], elements * sizeof(__half), cudaMemcpyDeviceToHost, nullptr);
+      cudaStreamSynchronize(nullptr);
+
+      float difference = 0.0f;
+      for (size_t i = 0; i < elements; ++i)
+      {
+        difference = std::max(difference, std::fabs(__half2float(hostA[i]) - __half2float(hostB[i])));
+      }
+      printKernelCase(output, kernel, iterations, "bilinear kernel", baselineUs, fusedUs, difference);
+    }
+  }
+
+  for (void *tensor : tensors)
+  {
+    if (tensor)
+    {
+      cudaFree(tensor);
+    }
+  }
+  if (source)
+  {
+    dwImage_destroy(source);
+  }
+  return ok;
+}
+
+static int runKernelBench(dwContextHandle_t sdk, uint32_t iterations, FILE *output)
+{
+  // the interpolation of the camera outputs
+  dwImageTransformationHandle_t transformation = DW_NULL_HANDLE;
+  dwImageTransformationParameters params{false};
+  dwStatus status = dwImageTransformation_initialize(&transformation, params, sdk);
+  if (status != DW_SUCCESS)
+  {
+    ROS_ERROR("Cannot initialize image transformation. Error: %s", dwGetStatusName(status));
+    return NV_ERR;
+  }
+  dwImageTransformation_setInterpolationMode(DW_IMAGEPROCESSING_INTERPOLATION_DEFAULT, transformation);
+
+  int result = 0;
+  for (const KernelCase &kernel : kernelCases)
+  {
+    const bool ok = kernel.output == DW_IMAGE_FORMAT_UNKNOWN
+                        ? benchTensorCase(kernel, iterations, sdk, output)
+                        : benchFrameCase(kernel, iterations, sdk, transformation, output);
+    if (!ok)
+    {
+      ROS_ERROR("Kernel benchmark %s failed", kernel.name);
+      result = NV_ERR;
+    }
+  }
+
+  dwImageTransformation_release(transformation);
+  return result;
+}
+
+static void usage()
+{
+  fprintf(stderr, "usage: nv_sensors_bench --video <file> [--duration <s>] [--rate <Hz>] [--modes <mode,...>] [--kernels <iterations>] [--output <file.jsonl>]\n"
+                  "modes:");
+  for (const BenchMode &mode : benchModes)
+  {
+    fprintf(stderr, " %s", mode.name);
+  }
+  fprintf(stderr, "\nkernels:");
+  for (const KernelCase &kernel : kernelCases)
+  {
+    fprintf(stderr, " %s", kernel.name);
+  }
+  fprintf(stderr, "\n");
+}
+
+/* Main function*/
+int main(int argc, char **argv)
+{
+  ros::init(argc, argv, "nv_sensors_bench", ros::init_options::AnonymousName);
+
+  std::string video;
+  std::string modes;
+  std::string outputPath;
+  double duration = 10.0;
+  double rate = 0.0;
+  int kernelIterations = 0;
+  for (int i = 1; i + 1 < argc; i += 2)
+  {
+    if (!strcmp(argv[i], "--video"))
+      video = argv[i + 1];
+    else if (!strcmp(argv[i], "--duration"))
+      duration = atof(argv[i + 1]);
+    else if (!strcmp(argv[i], "--rate"))
+      rate = atof(argv[i + 1]);
+    else if (!strcmp(argv[i], "--modes"))
+      modes = argv[i + 1];
+    else if (!strcmp(argv[i], "--kernels"))
+      kernelIterations = atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--output"))
+      outputPath = argv[i + 1];
+    else
+    {
+      usage();
+      return NV_ERR;
+    }
+  }
+  if ((video.empty() && kernelIterations <= 0) || duration <= 0.0 || kernelIterations < 0)
+  {
+    usage();
+    return NV_ERR;
+  }
+
+  FILE *output = stdout;
+  if (!outputPath.empty())
+  {
+    output = fopen(outputPath.c_str(), "a");
+    if (!output)
+    {
+      fprintf(stderr, "Cannot open %s: %s\n", outputPath.c_str(), strerror(errno));
+      return NV_ERR;
+    }
+  }
+
+  ros::NodeHandle nh;
+  ros::NodeHandle pnh("~");
+  // statistics are collected once per mode, paced replay with --rate
+  pnh.setParam("stats_period", 0.0);
+  pnh.setParam("capture_rate", rate);
+  // the benchmark has no subscribers, every output is converted regardless
+  pnh.setParam("lazy", false);
+
+  dwContextHandle_t sdk = DW_NULL_HANDLE;
+  dwSALHandle_t hal = DW_NULL_HANDLE;
+  dwContextParameters sdkParams = {};
+  dwStatus status = dwInitialize(&sdk, DW_VERSION, &sdkParams);
+  if (status != DW_SUCCESS)
+  {
+    ROS_ERROR("Failed to init Driveworks SDK. Error: %s", dwGetStatusName(status));
+    return NV_ERR;
+  }
+  status = dwSAL_initialize(&hal, sdk);
+  if (status != DW_SUCCESS)
+  {
+    ROS_ERROR("Failed to create HAL module of Driveworks SDK. Error: %s", dwGetStatusName(status));
+    dwRelease(sdk);
+    return NV_ERR;
+  }
+
+  int result = 0;
+  if (kernelIterations > 0)
+  {
+    result = runKernelBench(sdk, static_cast<uint32_t>(kernelIterations), output);
+  }
+
+  SensorCamera camera;
+  camera.initialize(sdk, hal);
+  camera.setNodeHandle(nh, pnh);
+
+  for (const BenchMode &mode : benchModes)
+  {
+    if (video.empty())
+    {
+      break;
+    }
+    if (!modes.empty() && ("," + modes + ",").find("," + std::string(mode.name) + ",") == std::string::npos)
+    {
+      continue;
+    }
+
+    std::string params = "video=" + video;
+    if (mode.params[0])
+    {
+      params += std::string(",") + mode.params;
+    }
+
+    dwSensorParams sensorParams{};
+    sensorParams.protocol = "camera.virtual";
+    sensorParams.parameters = params.c_str();
+    if (!camera.start(sensorParams))
+    {
+      ROS_ERROR("Cannot start mode %s", mode.name);
+      result = NV_ERR;
+      continue;
+    }
+
+    // discard the start-up, then measure until the duration passed or the recording ended
+    diagnostic_msgs::DiagnosticArray diagnostics;
+    camera.collectStats(diagnostics);
+    const uint64_t allocations = allocationCount.load();
+    const uint64_t captured = camera.getCapturedCount(0);
+    const double cpu = getCpuSeconds();
+    const auto start = std::chrono::steady_clock::now();
+
+    uint64_t lastCaptured = captured;
+    auto lastProgress = start;
+    while (ros::ok() && std::chrono::steady_clock::now() - start < std::chrono::duration<double>(duration))
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      if (camera.getCapturedCount(0) != lastCaptured)
+      {
+        lastCaptured = camera.getCapturedCount(0);
+        lastProgress = std::chrono::steady_clock::now();
+      }
+      else if (std::chrono::steady_clock::now() - lastProgress > std::chrono::seconds(1))
+      {
+        break;
+      }
+    }
+
+    camera.collectStats(diagnostics);
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double cpuPercent = 100.0 * (getCpuSeconds() - cpu) / elapsed;
+    const uint64_t frames = camera.getCapturedCount(0) - captured;
+    const double allocationsPerFrame = frames ? static_cast<double>(allocationCount.load() - allocations) / frames : 0.0;
+
+    camera.stop();
+
+    fprintf(output, "{\"mode\":%s,\"video\":%s,\"rate\":%.1f,\"seconds\":%.3f,\"frames\":%lu,\"fps\":%.2f,"
+                    "\"cpu_percent\":%.1f,\"allocations_per_frame\":%.2f,\"stats\":[",
+            quote(mode.name).c_str(), quote(video).c_str(), rate, elapsed, static_cast<unsigned long>(frames),
+            frames / elapsed, cpuPercent, allocationsPerFrame);
+    for (size_t i = 0; i < diagnostics.status.size(); ++i)
+    {
+      fprintf(output, "%s%s", i ? "," : "", toJson(diagnostics.status[i]).c_str());
+    }
+    fprintf(output, "]}\n");
+    fflush(output);
+  }
+
+  if (output != stdout)
+  {
+    fclose(output);
+  }
+
+  dwSAL_release(hal);
+  dwRelease(sdk);
+
+  return result;
+}
@@ -0,0 +1,50 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sensors_node.h"
+
+#include <nodelet/nodelet.h>
+#include <pluginlib/class_list_macros.h>
+
+namespace nv
+{
+
+  /**
+   * @class SensorsNodelet
+   * @brief Nodelet hosting the producer
+   * @details Loaded into the same nodelet manager as the consumers, pooled
+   * images are handed to them as ImageConstPtr without serialization or copy.
+   */
+  class SensorsNodelet : public nodelet::Nodelet
+  {
+
+  public:
+    ~SensorsNodelet()
+    {
+      m_node.release();
+    }
+
+  private:
+    virtual void onInit()
+    {
+      // the multi-threaded queue of the manager, a long callback does not hold up the others
+      if (!m_node.initialize(getMTNodeHandle(), getMTPrivateNodeHandle()))
+      {
+        NODELET_ERROR("Nv sensors nodelet initialization failed");
+      }
+    }
+
+    SensorsNode m_node;
+  };
+
+} // namespace nv
+
+PLUGINLIB_EXPORT_CLASS(nv::SensorsNodelet, nodelet::Nodelet)
@@ -135,9 +135,24 @@ namespace nv
   /** Constant string for starting camera capture services. */
   const std::string StartCameraCaptureService("camera_start");
 
+  /** Constant string for preparing cameras without starting them. */
+  const std::string PrepareCameraCaptureService("camera_prepare");
+
+  /** Constant string for releasing prepared cameras. */
+  const std::string ReleaseCameraCaptureService("camera_release");
+
   /** Constant string for closing camera capture services. */
   const std::string StopCameraCaptureService("camera_stop");
 
+  /** Constant string for reconfiguring the outputs of a running camera. */
+  const std::string ReconfigureCameraService("camera_reconfigure");
+
+  /** Constant string for starting the disk recording of running cameras. */
+  const std::string StartCameraRecordService("camera_record_start");
+
+  /** Constant string for stopping the disk recording of running cameras. */
+  const std::string StopCameraRecordService("camera_record_stop");
+
   /** Constant string for initializing CUDA processing services. */
   const std::string InitCudaProcessingService("nv_init_cuda_processing");
 
@@ -0,0 +1,79 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "pipeline_stats.h"
+
+namespace nv
+{
+
+  int64_t LatencyHistogram::getBucketLimit(uint32_t bucket)
+  {
+    if (bucket < 16)
+    {
+      return bucket;
+    }
+
+    uint32_t msb = 4 + (bucket - 16) / 4;
+    uint64_t sub = (bucket - 16) % 4;
+    return static_cast<int64_t>(((4 + sub + 1) << (msb - 2)) - 1);
+  }
+
+  LatencyHistogram::Summary LatencyHistogram::collect()
+  {
+    uint64_t counts[BUCKET_COUNT];
+    Summary summary;
+    for (uint32_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+      counts[i] = m_buckets[i].exchange(0, std::memory_order_relaxed);
+      summary.count += counts[i];
+    }
+    summary.max = m_max.exchange(0, std::memory_order_relaxed);
+
+    if (summary.count == 0)
+    {
+      return summary;
+    }
+
+    // ranks of the percentiles, rounded up
+    const uint64_t p50Rank = (summary.count + 1) / 2;
+    const uint64_t p99Rank = (summary.count * 99 + 99) / 100;
+
+    uint64_t seen = 0;
+    bool p50Found = false;
+    for (uint32_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+      seen += counts[i];
+      if (!p50Found && seen >= p50Rank)
+      {
+        summary.p50 = getBucketLimit(i);
+        p50Found = true;
+      }
+      if (seen >= p99Rank)
+      {
+        summary.p99 = getBucketLimit(i);
+        break;
+      }
+    }
+
+    // the bucket limit may exceed what was actually recorded
+    if (summary.p50 > summary.max)
+    {
+      summary.p50 = summary.max;
+    }
+    if (summary.p99 > summary.max)
+    {
+      summary.p99 = summary.max;
+    }
+
+    return summary;
+  }
+
+} // namespace nv
@@ -0,0 +1,121 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "rig_config.h"
+#include "camera.h"
+
+#include <dw/rig/Rig.h>
+#include <ros/ros.h>
+
+namespace nv
+{
+
+  // one parameter set of the start request, or false if the camera cannot be used
+  static bool loadRigCamera(dwRigHandle_t rig, uint32_t camera, std::string &protocol, std::string &params)
+  {
+    uint32_t sensorId = 0;
+    dwStatus status = dwRig_findSensorByTypeIndex(&sensorId, DW_SENSOR_CAMERA, camera, rig);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot find camera %u in the rig. Error: %s", camera, dwGetStatusName(status));
+      return false;
+    }
+
+    const char *name = nullptr;
+    const char *sensorProtocol = nullptr;
+    const char *sensorParams = nullptr;
+    status = dwRig_getSensorName(&name, sensorId, rig);
+    if (status == DW_SUCCESS)
+    {
+      status = dwRig_getSensorProtocol(&sensorProtocol, sensorId, rig);
+    }
+    if (status == DW_SUCCESS)
+    {
+      // file paths of virtual sensors are resolved relative to the rig
+      status = dwRig_getSensorParameterUpdatedPath(&sensorParams, sensorId, rig);
+    }
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot read camera %u of the rig. Error: %s", camera, dwGetStatusName(status));
+      return false;
+    }
+
+    if (!protocol.empty() && protocol != sensorProtocol)
+    {
+      ROS_ERROR("Rig camera %s uses %s, all cameras must use %s", name, sensorProtocol, protocol.c_str());
+      return false;
+    }
+    protocol = sensorProtocol;
+
+    // output options are optional
+    const char *outputs = nullptr;
+    if (dwRig_getSensorPropertyByName(&outputs, RIG_OUTPUT_PROPERTY, sensorId, rig) != DW_SUCCESS)
+    {
+      outputs = nullptr;
+    }
+
+    params = sensorParams;
+    if (outputs && outputs[0] != '\0')
+    {
+      params += std::string(params.empty() ? "" : ",") + outputs;
+    }
+    params += std::string(params.empty() ? "" : ",") + "frame-id=" + name + ",rig-sensor=" + name;
+
+    if (params.find(SensorCamera::CAMERA_PARAMS_SEPARATOR) != std::string::npos)
+    {
+      ROS_ERROR("Parameters of rig camera %s must not contain '%c'", name, SensorCamera::CAMERA_PARAMS_SEPARATOR);
+      return false;
+    }
+
+    ROS_INFO("rig camera %u %s: %s %s", camera, name, sensorProtocol, params.c_str());
+
+    return true;
+  }
+
+  bool loadRigCameras(dwContextHandle_t context, const std::string &path, std::string &protocol, std::string &params)
+  {
+    dwRigHandle_t rig = DW_NULL_HANDLE;
+    dwStatus status = dwRig_initializeFromFile(&rig, context, path.c_str());
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Cannot load rig %s. Error: %s", path.c_str(), dwGetStatusName(status));
+      return false;
+    }
+
+    uint32_t cameraCount = 0;
+    status = dwRig_getSensorCountOfType(&cameraCount, DW_SENSOR_CAMERA, rig);
+    if (status != DW_SUCCESS || cameraCount == 0)
+    {
+      ROS_ERROR("Rig %s holds no camera", path.c_str());
+      dwRig_release(rig);
+      return false;
+    }
+
+    protocol.clear();
+    params.clear();
+    bool success = true;
+    for (uint32_t i = 0; i < cameraCount && success; ++i)
+    {
+      std::string cameraParams;
+      success = loadRigCamera(rig, i, protocol, cameraParams);
+      if (i > 0)
+      {
+        params += SensorCamera::CAMERA_PARAMS_SEPARATOR;
+      }
+      params += cameraParams;
+    }
+
+    dwRig_release(rig);
+
+    return success;
+  }
+
+} // namespace nv
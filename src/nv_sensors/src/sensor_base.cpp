@@ -0,0 +1,101 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sensor_base.h"
+
+#include <cstdio>
+
+namespace nv
+{
+
+  bool SensorBase::loadCommonOptions()
+  {
+    m_privateNodeHandle.param("stats_period", m_statsPeriod, 1.0);
+    m_privateNodeHandle.param("time_sync_period", m_timeSyncPeriod, 1.0);
+    if (!m_clock.initialize(m_privateNodeHandle, m_sdk))
+    {
+      return false;
+    }
+
+    return loadThreadPolicy(m_privateNodeHandle, "capture", m_capturePolicy) &&
+           loadThreadPolicy(m_privateNodeHandle, "convert", m_convertPolicy) &&
+           loadThreadPolicy(m_privateNodeHandle, "publish", m_publishPolicy);
+  }
+
+  void SensorBase::startTimers()
+  {
+    // the offset to ROS time follows clock corrections while the sensor runs
+    if (m_clock.getDomain() == TimeMapper::ROS && m_timeSyncPeriod > 0.0)
+    {
+      m_clockTimer = m_nodeHandle.createWallTimer(ros::WallDuration(m_timeSyncPeriod), &SensorBase::syncClock, this);
+    }
+
+    // stage timings are always recorded, publishing them is optional
+    m_statsTime = PipelineClock::now();
+    if (m_statsPeriod > 0.0)
+    {
+      m_diagnosticsPub = m_nodeHandle.advertise<diagnostic_msgs::DiagnosticArray>("/diagnostics", 1);
+      m_statsTimer = m_nodeHandle.createWallTimer(ros::WallDuration(m_statsPeriod), &SensorBase::publishStats, this);
+    }
+  }
+
+  void SensorBase::stopTimers()
+  {
+    m_statsTimer.stop();
+    m_clockTimer.stop();
+    m_diagnosticsPub.shutdown();
+  }
+
+  void SensorBase::syncClock(const ros::WallTimerEvent &event)
+  {
+    m_clock.update();
+  }
+
+  void SensorBase::publishStats(const ros::WallTimerEvent &event)
+  {
+    // a period is skipped while the sensor is being changed
+    std::unique_lock<std::mutex> lock(m_statsMutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+      return;
+    }
+
+    diagnostic_msgs::DiagnosticArrayPtr diagnostics(new diagnostic_msgs::DiagnosticArray);
+    collectStats(*diagnostics);
+
+    m_diagnosticsPub.publish(diagnostics);
+  }
+
+  void SensorBase::addValue(diagnostic_msgs::DiagnosticStatus &status, const std::string &key, const std::string &value)
+  {
+    diagnostic_msgs::KeyValue entry;
+    entry.key = key;
+    entry.value = value;
+    status.values.push_back(entry);
+  }
+
+  void SensorBase::addStage(diagnostic_msgs::DiagnosticStatus &status, const std::string &stage,
+                            LatencyHistogram &histogram)
+  {
+    LatencyHistogram::Summary summary = histogram.collect();
+    addValue(status, stage + " p50 us", std::to_string(summary.p50));
+    addValue(status, stage + " p99 us", std::to_string(summary.p99));
+    addValue(status, stage + " max us", std::to_string(summary.max));
+  }
+
+  std::string SensorBase::formatRate(double rate)
+  {
+    char text[32];
+    snprintf(text, sizeof(text), "%.1f", rate);
+    return text;
+  }
+
+} // namespace nv
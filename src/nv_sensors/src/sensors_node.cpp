@@ -0,0 +1,433 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sensors_node.h"
+#include "nvcommon.h"
+#include "rig_config.h"
+
+//dw core
+#include <dw/core/Context.h>
+#include <dw/core/VersionCurrent.h>
+
+namespace nv
+{
+
+  // the other sensors take the last thread slots, the cameras count up from the first
+  static const uint32_t LIDAR_THREAD_SLOT = SensorCamera::MAX_CAMERAS - 1;
+  static const uint32_t IMU_THREAD_SLOT = SensorCamera::MAX_CAMERAS - 2;
+
+  SensorsNode::~SensorsNode()
+  {
+    release();
+  }
+
+  bool SensorsNode::startSensor(SensorBase &sensor, const ros::NodeHandle &pnh, const std::string &name, uint32_t slot)
+  {
+    std::string protocol;
+    std::string parameters;
+    pnh.param(name + "_protocol", protocol, std::string());
+    pnh.param(name + "_params", parameters, std::string());
+    if (protocol.empty())
+    {
+      return true;
+    }
+
+    sensor.initialize(m_sdk, m_hal);
+    sensor.setNodeHandle(m_nodeHandle, pnh);
+    sensor.setThreadSlot(slot);
+
+    dwSensorParams params{};
+    params.protocol = protocol.c_str();
+    params.parameters = parameters.c_str();
+    return sensor.start(params);
+  }
+
+  bool SensorsNode::initialize(const ros::NodeHandle &nh, const ros::NodeHandle &pnh)
+  {
+    m_nodeHandle = nh;
+
+    /* instantiate Driveworks SDK context*/
+    dwContextParameters sdkParams = {};
+    dwStatus status = dwInitialize(&m_sdk, DW_VERSION, &sdkParams);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Failed to init Driveworks SDK. Error: %s", dwGetStatusName(status));
+      m_sdk = DW_NULL_HANDLE;
+      return false;
+    }
+
+    /* create HAL module of the SDK */
+    status = dwSAL_initialize(&m_hal, m_sdk);
+    if (status != DW_SUCCESS)
+    {
+      ROS_ERROR("Failed to create HAL module of Driveworks SDK. Error: %s", dwGetStatusName(status));
+      m_hal = DW_NULL_HANDLE;
+      release();
+      return false;
+    }
+
+    m_cameraSensor.initialize(m_sdk, m_hal);
+    m_cameraSensor.setNodeHandle(nh, pnh);
+
+    // lidar and IMU run from launch on the same context, SAL and thread policies as the cameras
+    if (!startSensor(m_lidarSensor, pnh, "lidar", LIDAR_THREAD_SLOT) ||
+        !startSensor(m_imuSensor, pnh, "imu", IMU_THREAD_SLOT))
+    {
+      release();
+      return false;
+    }
+
+    // the state is latched, a late subscriber still learns the outcome of the last request
+    m_statusPub = m_nodeHandle.advertise<nv_sensors::CameraStatus>("camera_status", 1, true);
+    publishStatus("", true, "");
+
+    pnh.param("async_control", m_asyncControl, true);
+    if (m_asyncControl)
+    {
+      m_controlRun = true;
+      m_controlThread = std::thread(&SensorsNode::run_control, this);
+    }
+
+    // cameras prepared at startup are started by camera_start without allocating anything
+    ControlRequest prepare{ControlRequest::PREPARE, std::string(), std::string()};
+    pnh.param("prepare_driver", prepare.driver, std::string());
+    pnh.param("prepare_params", prepare.params, std::string());
+
+    // a rig brings up all of its cameras at once
+    std::string rigPath;
+    pnh.param("rig", rigPath, std::string());
+    if (!rigPath.empty())
+    {
+      if (!prepare.driver.empty())
+      {
+        ROS_WARN("~rig replaces ~prepare_driver %s", prepare.driver.c_str());
+      }
+      if (!loadRigCameras(m_sdk, rigPath, prepare.driver, prepare.params))
+      {
+        release();
+        return false;
+      }
+    }
+
+    if (!prepare.driver.empty())
+    {
+      submit(prepare);
+    }
+
+    bool rigStart = true;
+    pnh.param("rig_start", rigStart, true);
+    if (!rigPath.empty() && rigStart)
+    {
+      submit({ControlRequest::START, prepare.driver, prepare.params});
+    }
+
+    /*Service callback functions*/
+    ROS_INFO("Advertising Camera Start, Camera Stop, Camera Prepare, Camera Release, Camera Reconfigure and Camera Record Services.");
+    m_cameraStartService = m_nodeHandle.advertiseService(StartCameraCaptureService, &SensorsNode::onCameraStart, this);
+    m_cameraStopService = m_nodeHandle.advertiseService(StopCameraCaptureService, &SensorsNode::onCameraStop, this);
+    m_cameraPrepareService = m_nodeHandle.advertiseService(PrepareCameraCaptureService, &SensorsNode::onCameraPrepare, this);
+    m_cameraReleaseService = m_nodeHandle.advertiseService(ReleaseCameraCaptureService, &SensorsNode::onCameraRelease, this);
+    m_cameraReconfigureService = m_nodeHandle.advertiseService(ReconfigureCameraService, &SensorsNode::onCameraReconfigure, this);
+    m_recordStartService = m_nodeHandle.advertiseService(StartCameraRecordService, &SensorsNode::onRecordStart, this);
+    m_recordStopService = m_nodeHandle.advertiseService(StopCameraRecordService, &SensorsNode::onRecordStop, this);
+
+    return true;
+  }
+
+  void SensorsNode::release()
+  {
+    m_cameraStartService.shutdown();
+    m_cameraStopService.shutdown();
+    m_cameraPrepareService.shutdown();
+    m_cameraReleaseService.shutdown();
+    m_cameraReconfigureService.shutdown();
+    m_recordStartService.shutdown();
+    m_recordStopService.shutdown();
+
+    // a running request is finished, queued ones are dropped
+    {
+      std::lock_guard<std::mutex> lock(m_controlMutex);
+      m_controlRun = false;
+      m_controlQueue.clear();
+    }
+    m_controlCondition.notify_one();
+    if (m_controlThread.joinable())
+    {
+      m_controlThread.join();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_sensorMutex);
+      m_cameraSensor.release();
+    }
+    m_lidarSensor.release();
+    m_imuSensor.release();
+    m_statusPub.shutdown();
+
+    // release used objects in correct order
+    if (m_hal)
+    {
+      dwSAL_release(m_hal);
+      m_hal = DW_NULL_HANDLE;
+    }
+
+    if (m_sdk)
+    {
+      dwRelease(m_sdk);
+      m_sdk = DW_NULL_HANDLE;
+    }
+  }
+
+  static const char *getCommandName(int command)
+  {
+    static const char *names[] = {"start", "stop", "prepare", "release"};
+    return names[command];
+  }
+
+  bool SensorsNode::submit(const ControlRequest &request)
+  {
+    if (!m_asyncControl)
+    {
+      return execute(request);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_controlMutex);
+      if (!m_controlRun)
+      {
+        return false;
+      }
+      m_controlQueue.push_back(request);
+    }
+    m_controlCondition.notify_one();
+    ROS_INFO("camera %s request queued", getCommandName(request.command));
+
+    return true;
+  }
+
+  void SensorsNode::run_control()
+  {
+    std::unique_lock<std::mutex> lock(m_controlMutex);
+    while (true)
+    {
+      m_controlCondition.wait(lock, [this] { return !m_controlRun || !m_controlQueue.empty(); });
+      if (!m_controlRun)
+      {
+        return;
+      }
+
+      ControlRequest request = m_controlQueue.front();
+      m_controlQueue.pop_front();
+      lock.unlock();
+      execute(request);
+      lock.lock();
+    }
+  }
+
+  bool SensorsNode::execute(const ControlRequest &request)
+  {
+    const std::string command = getCommandName(request.command);
+
+    // the short services back off while the cameras change
+    m_controlBusy = true;
+    std::lock_guard<std::mutex> lock(m_sensorMutex);
+
+    dwSensorParams params{};
+    params.parameters = request.params.c_str();
+    params.protocol = request.driver.c_str();
+
+    bool success = false;
+    std::string message;
+    switch (request.command)
+    {
+    case ControlRequest::START:
+      if (m_cameraSensor.isSensorsRunning())
+      {
+        ROS_WARN("Service already running. camera sensor data being published for %u camera(s)", m_cameraSensor.getCameraCount());
+        message = "already running";
+        break;
+      }
+      ROS_INFO("Service params called are as follows: %s %s", request.driver.c_str(), request.params.c_str());
+      publishStatus("starting", command, true, request.driver + " " + request.params);
+      success = m_cameraSensor.start(params);
+      if (!success)
+      {
+        ROS_ERROR("Cannot start %s %s", request.driver.c_str(), request.params.c_str());
+      }
+      message = success ? std::to_string(m_cameraSensor.getCameraCount()) + " camera(s) running" : "start failed";
+      break;
+
+    case ControlRequest::STOP:
+      if (!m_cameraSensor.isSensorsRunning())
+      {
+        ROS_WARN("camera sensor is not running");
+        message = "not running";
+        break;
+      }
+      publishStatus("stopping", command, true, "");
+      success = m_cameraSensor.stop();
+      message = success ? "stopped" : "stop failed";
+      break;
+
+    case ControlRequest::PREPARE:
+      if (m_cameraSensor.isSensorsRunning())
+      {
+        ROS_WARN("Service already running. camera sensor data being published for %u camera(s)", m_cameraSensor.getCameraCount());
+        message = "already running";
+        break;
+      }
+      ROS_INFO("Preparing cameras with params: %s %s", request.driver.c_str(), request.params.c_str());
+      publishStatus("preparing", command, true, request.driver + " " + request.params);
+      success = m_cameraSensor.prepare(params);
+      if (!success)
+      {
+        ROS_WARN("Cannot prepare %s %s, camera_start allocates the cameras", request.driver.c_str(), request.params.c_str());
+      }
+      message = success ? std::to_string(m_cameraSensor.getCameraCount()) + " camera(s) prepared" : "prepare failed";
+      break;
+
+    case ControlRequest::RELEASE:
+      if (!m_cameraSensor.isPrepared())
+      {
+        ROS_WARN("camera sensor is not prepared");
+        message = "not prepared";
+        break;
+      }
+      publishStatus("releasing", command, true, "");
+      m_cameraSensor.release();
+      success = true;
+      message = "released";
+      break;
+    }
+
+    publishStatus(command, success, message);
+    m_controlBusy = false;
+
+    return success;
+  }
+
+  void SensorsNode::publishStatus(const std::string &command, bool success, const std::string &message)
+  {
+    const std::string state = m_cameraSensor.isSensorsRunning() ? "running"
+                              : m_cameraSensor.isPrepared()     ? "prepared"
+                                                                : "idle";
+    publishStatus(state, command, success, message);
+  }
+
+  void SensorsNode::publishStatus(const std::string &state, const std::string &command, bool success,
+                                  const std::string &message)
+  {
+    nv_sensors::CameraStatusPtr status(new nv_sensors::CameraStatus);
+    status->header.stamp = ros::Time::now();
+    status->state = state;
+    status->command = command;
+    status->success = success;
+    status->message = message;
+    status->cameras = m_cameraSensor.getCameraCount();
+    m_statusPub.publish(status);
+  }
+
+  /* Service callback funtions*/
+  bool SensorsNode::onCameraStart(nv_sensors::camera_start::Request &req,
+                                  nv_sensors::camera_start::Response &res)
+  {
+    res.success = submit({ControlRequest::START, req.driver, req.params});
+    return res.success;
+  }
+
+  bool SensorsNode::onCameraStop(nv_sensors::camera_stop::Request &req,
+                                 nv_sensors::camera_stop::Response &res)
+  {
+    res.success = submit({ControlRequest::STOP, std::string(), std::string()});
+    return res.success;
+  }
+
+  bool SensorsNode::onCameraPrepare(nv_sensors::camera_start::Request &req,
+                                    nv_sensors::camera_start::Response &res)
+  {
+    res.success = submit({ControlRequest::PREPARE, req.driver, req.params});
+    return res.success;
+  }
+
+  bool SensorsNode::onCameraRelease(nv_sensors::camera_stop::Request &req,
+                                    nv_sensors::camera_stop::Response &res)
+  {
+    res.success = submit({ControlRequest::RELEASE, std::string(), std::string()});
+    return res.success;
+  }
+
+  bool SensorsNode::onCameraReconfigure(nv_sensors::camera_reconfigure::Request &req,
+                                        nv_sensors::camera_reconfigure::Response &res)
+  {
+    if (m_controlBusy)
+    {
+      ROS_WARN("camera sensor is starting or stopping, try again later");
+      res.success = false;
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_sensorMutex);
+    if (!m_cameraSensor.isSensorsRunning())
+    {
+      ROS_WARN("camera sensor is not running");
+      res.success = false;
+      return false;
+    }
+
+    res.success = m_cameraSensor.reconfigure(req.camera, req.params);
+    return res.success;
+  }
+
+  bool SensorsNode::onRecordStart(nv_sensors::camera_record_start::Request &req,
+                                  nv_sensors::camera_record_start::Response &res)
+  {
+    if (m_controlBusy)
+    {
+      ROS_WARN("camera sensor is starting or stopping, try again later");
+      res.success = false;
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_sensorMutex);
+    if (!m_cameraSensor.isSensorsRunning())
+    {
+      ROS_WARN("camera sensor is not running");
+      res.success = false;
+      return false;
+    }
+
+    res.success = m_cameraSensor.startRecording(req.cameras, req.directory, req.format);
+    return res.success;
+  }
+
+  bool SensorsNode::onRecordStop(nv_sensors::camera_record_stop::Request &req,
+                                 nv_sensors::camera_record_stop::Response &res)
+  {
+    if (m_controlBusy)
+    {
+      ROS_WARN("camera sensor is starting or stopping, try again later");
+      res.success = false;
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_sensorMutex);
+    if (!m_cameraSensor.isSensorsRunning())
+    {
+      ROS_WARN("camera sensor is not running");
+      res.success = false;
+      return false;
+    }
+
+    res.success = m_cameraSensor.stopRecording(req.cameras);
+    return res.success;
+  }
+
+} // namespace nv
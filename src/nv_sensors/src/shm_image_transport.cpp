@@ -0,0 +1,88 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "shm_image_transport.h"
+
+#include <pluginlib/class_list_macros.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace nv
+{
+
+  void ShmPublisher::publish(const sensor_msgs::Image &message, const PublishFn &publish_fn) const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const size_t size = message.data.size();
+    if ((!m_ring.isOpen() || size > m_ring.getSlotSize()) &&
+        !m_ring.create(ShmRing::getSegmentName(getTopic()), ShmRing::DEFAULT_SLOT_COUNT, size))
+    {
+      return;
+    }
+
+    uint32_t slot;
+    uint8_t *data = m_ring.acquire(slot);
+    if (!data)
+    {
+      ROS_WARN_THROTTLE(1.0, "/%s every shared-memory slot is held by a subscriber, dropping image", getTopic().c_str());
+      return;
+    }
+    memcpy(data, message.data.data(), size);
+
+    nv_sensors::ShmImage descriptor;
+    descriptor.header = message.header;
+    descriptor.height = message.height;
+    descriptor.width = message.width;
+    descriptor.encoding = message.encoding;
+    descriptor.is_bigendian = message.is_bigendian;
+    descriptor.step = message.step;
+    descriptor.segment = m_ring.getName();
+    descriptor.slot = slot;
+    descriptor.generation = m_ring.commit(slot, size);
+    descriptor.size = static_cast<uint32_t>(size);
+    publish_fn(descriptor);
+  }
+
+  void ShmSubscriber::internalCallback(const nv_sensors::ShmImage::ConstPtr &message, const Callback &user_cb)
+  {
+    // a restarted or resized publisher creates an object of a new name
+    if ((!m_ring.isOpen() || m_ring.getName() != message->segment) && !m_ring.open(message->segment))
+    {
+      return;
+    }
+
+    size_t size;
+    const uint8_t *data = m_ring.lock(message->slot, message->generation, size);
+    if (!data)
+    {
+      ROS_DEBUG("shared-memory slot %u of %s was overwritten, dropping image", message->slot, message->segment.c_str());
+      return;
+    }
+
+    sensor_msgs::ImagePtr image(new sensor_msgs::Image);
+    image->header = message->header;
+    image->height = message->height;
+    image->width = message->width;
+    image->encoding = message->encoding;
+    image->is_bigendian = message->is_bigendian;
+    image->step = message->step;
+    image->data.assign(data, data + std::min<size_t>(size, message->size));
+    m_ring.unlock(message->slot);
+
+    user_cb(image);
+  }
+
+} // namespace nv
+
+PLUGINLIB_EXPORT_CLASS(nv::ShmPublisher, image_transport::PublisherPlugin)
+PLUGINLIB_EXPORT_CLASS(nv::ShmSubscriber, image_transport::SubscriberPlugin)
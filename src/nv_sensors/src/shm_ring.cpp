@@ -0,0 +1,333 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "shm_ring.h"
+
+#include <ros/ros.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace nv
+{
+
+  const uint32_t ShmRing::DEFAULT_SLOT_COUNT;
+
+  // "NVSH"
+  static const uint32_t RING_MAGIC = 0x4853564e;
+  static const uint32_t RING_VERSION = 2;
+
+  // set in the reference count while the writer fills a slot
+  static const uint32_t WRITER = 0x80000000u;
+
+  // the counters live in memory shared between processes, so they must not fall back to a lock
+  static_assert(ATOMIC_INT_LOCK_FREE == 2, "shared-memory slots need lock-free 32 bit atomics");
+
+  // padded to a cache line, the slots after it start on one
+  struct alignas(64) ShmRing::Header
+  {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t reserved;
+    uint64_t slotSize;
+    uint64_t dataOffset;
+  };
+
+  // one cache line per slot, a reader of one slot does not contend with the writer of the next
+  struct alignas(64) ShmRing::Slot
+  {
+    std::atomic<uint32_t> refs;
+    std::atomic<uint32_t> generation;
+    uint64_t size;
+  };
+
+  // POSIX shared-memory objects of Linux are the files of /dev/shm
+  static const char *SHM_DIRECTORY = "/dev/shm";
+
+  // removes the objects of the topic of name left behind by writers which are no longer running
+  static void removeStaleSegments(const std::string &name)
+  {
+    // /nv_sensors.<pid>.<epoch>.<topic>
+    const size_t pidStart = name.find('.') + 1;
+    const size_t epochStart = name.find('.', pidStart) + 1;
+    const size_t topicStart = name.find('.', epochStart);
+    if (pidStart == 0 || epochStart == 0 || topicStart == std::string::npos)
+    {
+      return;
+    }
+    const std::string prefix = name.substr(1, pidStart - 1);
+    const std::string topic = name.substr(topicStart);
+
+    DIR *directory = opendir(SHM_DIRECTORY);
+    if (!directory)
+    {
+      return;
+    }
+    while (struct dirent *file = readdir(directory))
+    {
+      const std::string candidate = file->d_name;
+      if (candidate.compare(0, prefix.size(), prefix) != 0 || candidate.size() < topic.size() ||
+          candidate.compare(candidate.size() - topic.size(), topic.size(), topic) != 0)
+      {
+        continue;
+      }
+
+      // the topic must follow the epoch right away, /a.b is not a ring of /a
+      char *end = nullptr;
+      const long pid = strtol(candidate.c_str() + prefix.size(), &end, 10);
+      if (pid <= 0 || *end != '.' || strchr(end + 1, '.') != candidate.c_str() + candidate.size() - topic.size())
+      {
+        continue;
+      }
+      if (kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH)
+      {
+        ROS_INFO("Removing shared-memory ring %s of stopped process %ld", candidate.c_str(), pid);
+        shm_unlink(("/" + candidate).c_str());
+      }
+    }
+    closedir(directory);
+  }
+
+  ShmRing::~ShmRing()
+  {
+    release();
+  }
+
+  bool ShmRing::create(const std::string &name, uint32_t slotCount, size_t slotSize)
+  {
+    release();
+    if (slotCount == 0 || slotSize == 0)
+    {
+      ROS_ERROR("Cannot create shared-memory ring %s with %u slots of %zu bytes", name.c_str(), slotCount, slotSize);
+      return false;
+    }
+
+    // slot payloads start on a page and on a cache line each
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t headerSize = sizeof(Header) + slotCount * sizeof(Slot);
+    const size_t dataOffset = (headerSize + page - 1) / page * page;
+    m_slotSize = (slotSize + 63) / 64 * 64;
+    m_mappingSize = dataOffset + slotCount * m_slotSize;
+
+    shm_unlink(name.c_str());
+    removeStaleSegments(name);
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+    if (fd < 0)
+    {
+      ROS_ERROR("Cannot create shared-memory ring %s. Error: %s", name.c_str(), strerror(errno));
+      return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(m_mappingSize)) != 0)
+    {
+      ROS_ERROR("Cannot allocate %zu bytes for shared-memory ring %s. Error: %s", m_mappingSize, name.c_str(),
+                strerror(errno));
+      close(fd);
+      shm_unlink(name.c_str());
+      return false;
+    }
+
+    void *mapping = mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+      ROS_ERROR("Cannot map shared-memory ring %s. Error: %s", name.c_str(), strerror(errno));
+      shm_unlink(name.c_str());
+      return false;
+    }
+    m_mapping = static_cast<uint8_t *>(mapping);
+    m_name = name;
+    m_slotCount = slotCount;
+    m_owner = true;
+    m_next = 0;
+    m_dropped = 0;
+
+    for (uint32_t s = 0; s < slotCount; ++s)
+    {
+      Slot *slot = new (m_mapping + sizeof(Header) + s * sizeof(Slot)) Slot;
+      slot->refs.store(0, std::memory_order_relaxed);
+      slot->generation.store(0, std::memory_order_relaxed);
+      slot->size = 0;
+    }
+
+    // readers check the header last, it is written once the slots are
+    Header *header = reinterpret_cast<Header *>(m_mapping);
+    header->version = RING_VERSION;
+    header->slotCount = slotCount;
+    header->reserved = 0;
+    header->slotSize = m_slotSize;
+    header->dataOffset = dataOffset;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = RING_MAGIC;
+
+    return true;
+  }
+
+  bool ShmRing::open(const std::string &name)
+  {
+    release();
+
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+    {
+      ROS_ERROR("Cannot open shared-memory ring %s. Error: %s", name.c_str(), strerror(errno));
+      return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header))
+    {
+      ROS_ERROR("Shared-memory ring %s is not initialized", name.c_str());
+      close(fd);
+      return false;
+    }
+
+    const size_t size = static_cast<size_t>(info.st_size);
+    void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+      ROS_ERROR("Cannot map shared-memory ring %s. Error: %s", name.c_str(), strerror(errno));
+      return false;
+    }
+
+    const Header *header = static_cast<const Header *>(mapping);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->magic != RING_MAGIC || header->version != RING_VERSION ||
+        header->dataOffset + header->slotCount * header->slotSize > size)
+    {
+      ROS_ERROR("Shared-memory ring %s has an unknown layout", name.c_str());
+      munmap(mapping, size);
+      return false;
+    }
+
+    m_mapping = static_cast<uint8_t *>(mapping);
+    m_mappingSize = size;
+    m_name = name;
+    m_slotCount = header->slotCount;
+    m_slotSize = header->slotSize;
+    m_owner = false;
+
+    return true;
+  }
+
+  void ShmRing::release()
+  {
+    if (!m_mapping)
+    {
+      return;
+    }
+
+    munmap(m_mapping, m_mappingSize);
+    m_mapping = nullptr;
+    if (m_owner)
+    {
+      shm_unlink(m_name.c_str());
+    }
+    m_owner = false;
+    m_slotCount = 0;
+    m_name.clear();
+  }
+
+  ShmRing::Slot *ShmRing::getSlot(uint32_t slot) const
+  {
+    static_assert(sizeof(Header) % alignof(Slot) == 0, "shared-memory slots must follow the header aligned");
+    return reinterpret_cast<Slot *>(m_mapping + sizeof(Header) + slot * sizeof(Slot));
+  }
+
+  uint8_t *ShmRing::acquire(uint32_t &slot)
+  {
+    const uint64_t dataOffset = reinterpret_cast<const Header *>(m_mapping)->dataOffset;
+
+    // the oldest slot first, a slot still read by a subscriber is skipped
+    for (uint32_t k = 0; k < m_slotCount; ++k)
+    {
+      const uint32_t s = (m_next + k) % m_slotCount;
+      Slot *candidate = getSlot(s);
+      uint32_t expected = 0;
+      if (candidate->refs.compare_exchange_strong(expected, WRITER, std::memory_order_acquire))
+      {
+        // descriptors of the previous frame in the slot no longer match
+        uint32_t generation = candidate->generation.load(std::memory_order_relaxed) + 1;
+        candidate->generation.store(generation == 0 ? 1 : generation, std::memory_order_relaxed);
+
+        m_next = s + 1;
+        slot = s;
+        return m_mapping + dataOffset + s * m_slotSize;
+      }
+    }
+
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  uint32_t ShmRing::commit(uint32_t slot, size_t size)
+  {
+    Slot *written = getSlot(slot);
+    written->size = size;
+    const uint32_t generation = written->generation.load(std::memory_order_relaxed);
+
+    // readers which saw the writer bit dropped their reference again, so only the bit is cleared
+    written->refs.fetch_sub(WRITER, std::memory_order_release);
+
+    return generation;
+  }
+
+  const uint8_t *ShmRing::lock(uint32_t slot, uint32_t generation, size_t &size)
+  {
+    if (!m_mapping || slot >= m_slotCount)
+    {
+      return nullptr;
+    }
+
+    Slot *published = getSlot(slot);
+    const uint32_t refs = published->refs.fetch_add(1, std::memory_order_acquire);
+    if ((refs & WRITER) || published->generation.load(std::memory_order_relaxed) != generation)
+    {
+      published->refs.fetch_sub(1, std::memory_order_release);
+      return nullptr;
+    }
+
+    size = published->size;
+    return m_mapping + reinterpret_cast<const Header *>(m_mapping)->dataOffset + slot * m_slotSize;
+  }
+
+  void ShmRing::unlock(uint32_t slot)
+  {
+    getSlot(slot)->refs.fetch_sub(1, std::memory_order_release);
+  }
+
+  std::string ShmRing::getSegmentName(const std::string &topic)
+  {
+    static std::atomic<uint32_t> epoch{0};
+
+    // object names hold a single leading slash
+    std::string name = "/nv_sensors." + std::to_string(getpid()) + "." +
+                       std::to_string(epoch.fetch_add(1, std::memory_order_relaxed)) + ".";
+    for (char c : topic)
+    {
+      if (c != '/' || name.back() != '.')
+      {
+        name += c == '/' ? '.' : c;
+      }
+    }
+    return name;
+  }
+
+} // namespace nv
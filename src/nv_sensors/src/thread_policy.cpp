@@ -0,0 +1,157 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "thread_policy.h"
+
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace nv
+{
+
+  // comma separated cores and ranges, e.g. "1,4-6"
+  static bool parseCpus(const std::string &value, std::vector<int> &cpus)
+  {
+    cpus.clear();
+
+    size_t begin = 0;
+    while (begin < value.size())
+    {
+      size_t end = value.find(',', begin);
+      if (end == std::string::npos)
+      {
+        end = value.size();
+      }
+
+      const std::string entry = value.substr(begin, end - begin);
+      begin = end + 1;
+
+      int first, last;
+      char tail;
+      int count = sscanf(entry.c_str(), "%d-%d%c", &first, &last, &tail);
+      if (count == 1)
+      {
+        last = first;
+      }
+      else if (count != 2)
+      {
+        return false;
+      }
+
+      if (first < 0 || last < first || last >= CPU_SETSIZE)
+      {
+        return false;
+      }
+      for (int cpu = first; cpu <= last; ++cpu)
+      {
+        cpus.push_back(cpu);
+      }
+    }
+
+    return true;
+  }
+
+  bool loadThreadPolicy(const ros::NodeHandle &pnh, const std::string &stage, ThreadPolicy &policy)
+  {
+    policy = ThreadPolicy();
+
+    std::string cpus;
+    pnh.param(stage + "_cpus", cpus, std::string());
+    if (!parseCpus(cpus, policy.cpus))
+    {
+      ROS_ERROR("Invalid %s_cpus %s, expected a list of cores such as 2,3 or 2-5", stage.c_str(), cpus.c_str());
+      return false;
+    }
+
+    std::string sched;
+    pnh.param(stage + "_sched", sched, std::string("other"));
+    if (sched == "other")
+    {
+      policy.policy = SCHED_OTHER;
+    }
+    else if (sched == "fifo")
+    {
+      policy.policy = SCHED_FIFO;
+    }
+    else if (sched == "rr")
+    {
+      policy.policy = SCHED_RR;
+    }
+    else
+    {
+      ROS_ERROR("Invalid %s_sched %s, expected other, fifo or rr", stage.c_str(), sched.c_str());
+      return false;
+    }
+
+    pnh.param(stage + "_priority", policy.priority, policy.policy == SCHED_OTHER ? 0 : 10);
+    if (policy.policy != SCHED_OTHER &&
+        (policy.priority < sched_get_priority_min(policy.policy) || policy.priority > sched_get_priority_max(policy.policy)))
+    {
+      ROS_ERROR("Invalid %s_priority %d for %s scheduling", stage.c_str(), policy.priority, sched.c_str());
+      return false;
+    }
+    if (policy.policy == SCHED_OTHER)
+    {
+      policy.priority = 0;
+    }
+
+    return true;
+  }
+
+  void applyThreadPolicy(std::thread &thread, const ThreadPolicy &policy, uint32_t index, const std::string &name)
+  {
+    pthread_t handle = thread.native_handle();
+    pthread_setname_np(handle, name.substr(0, 15).c_str());
+
+    if (!policy.cpus.empty())
+    {
+      const int cpu = policy.cpus[index % policy.cpus.size()];
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu, &set);
+
+      int error = pthread_setaffinity_np(handle, sizeof(set), &set);
+      if (error != 0)
+      {
+        ROS_WARN("Cannot pin thread %s to core %d. Error: %s", name.c_str(), cpu, strerror(error));
+      }
+    }
+
+    if (policy.policy != SCHED_OTHER)
+    {
+      struct sched_param param;
+      memset(&param, 0, sizeof(param));
+      param.sched_priority = policy.priority;
+
+      int error = pthread_setschedparam(handle, policy.policy, &param);
+      if (error != 0)
+      {
+        ROS_WARN("Cannot set real-time priority %d of thread %s. Error: %s", policy.priority, name.c_str(), strerror(error));
+      }
+    }
+  }
+
+  void lockMemory()
+  {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+      ROS_WARN("Cannot lock the process memory. Error: %s", strerror(errno));
+      return;
+    }
+
+    ROS_INFO("process memory locked");
+  }
+
+} // namespace nv
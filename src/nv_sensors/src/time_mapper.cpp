@@ -0,0 +1,119 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "time_mapper.h"
+
+#include <cstdlib>
+
+namespace nv
+{
+
+  const int64_t TimeMapper::MAX_STEP_US;
+
+  // readings of both clocks per estimate, the tightest one is kept
+  static const uint32_t SAMPLE_COUNT = 5;
+
+  // weight of a new estimate, 1 / SMOOTHING
+  static const int64_t SMOOTHING = 8;
+
+  static int64_t toMicroseconds(const ros::Time &time)
+  {
+    return static_cast<int64_t>(time.sec) * 1000000L + time.nsec / 1000;
+  }
+
+  bool TimeMapper::initialize(const ros::NodeHandle &pnh, dwContextHandle_t context)
+  {
+    m_context = context;
+    m_estimated = false;
+    m_offset = 0;
+    m_jitter = 0;
+
+    std::string domain;
+    pnh.param("time_domain", domain, std::string("sensor"));
+    if (domain == "sensor")
+    {
+      m_domain = SENSOR;
+      return true;
+    }
+    if (domain != "ros")
+    {
+      ROS_ERROR("Invalid time_domain %s, expected sensor or ros", domain.c_str());
+      return false;
+    }
+
+    m_domain = ROS;
+    update();
+    ROS_INFO("sensor timestamps mapped to ROS time, offset %ld us", getOffset());
+
+    return true;
+  }
+
+  bool TimeMapper::sample(int64_t &offset, int64_t &bracket)
+  {
+    const int64_t before = toMicroseconds(ros::Time::now());
+    dwTime_t sensor;
+    if (dwContext_getCurrentTime(&sensor, m_context) != DW_SUCCESS)
+    {
+      return false;
+    }
+    const int64_t after = toMicroseconds(ros::Time::now());
+
+    // the Driveworks clock was read in the middle of the bracket
+    bracket = after - before;
+    offset = before + bracket / 2 - sensor;
+
+    return true;
+  }
+
+  void TimeMapper::update()
+  {
+    if (m_domain != ROS)
+    {
+      return;
+    }
+
+    int64_t best = 0;
+    int64_t bestBracket = -1;
+    for (uint32_t i = 0; i < SAMPLE_COUNT; ++i)
+    {
+      int64_t offset, bracket;
+      if (sample(offset, bracket) && (bestBracket < 0 || bracket < bestBracket))
+      {
+        best = offset;
+        bestBracket = bracket;
+      }
+    }
+    if (bestBracket < 0)
+    {
+      ROS_WARN_THROTTLE(10.0, "Cannot read the Driveworks clock, time offset not updated");
+      return;
+    }
+
+    const int64_t current = getOffset();
+    const int64_t deviation = std::llabs(best - current);
+    if (!m_estimated || deviation > MAX_STEP_US)
+    {
+      if (m_estimated)
+      {
+        ROS_WARN("time offset stepped by %ld us", best - current);
+      }
+      m_offset.store(best, std::memory_order_relaxed);
+      m_jitter.store(0, std::memory_order_relaxed);
+      m_estimated = true;
+      return;
+    }
+
+    m_offset.store(current + (best - current) / SMOOTHING, std::memory_order_relaxed);
+    const int64_t jitter = getJitter();
+    m_jitter.store(jitter + (deviation - jitter) / SMOOTHING, std::memory_order_relaxed);
+  }
+
+} // namespace nv
@@ -0,0 +1,59 @@
+/* Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * NVIDIA CORPORATION and its licensors retain all intellectual property
+ * and proprietary rights in and to this software, related documentation
+ * and any modifications thereto.  Any use, reproduction, disclosure or
+ * distribution of this software and related documentation without an express
+ * license agreement from NVIDIA CORPORATION is strictly prohibited.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "video_packet.h"
+
+namespace nv
+{
+
+  // offset of the NAL unit after the start code 00 00 01 at or after from, size if there is none
+  static size_t findNalUnit(const uint8_t *data, size_t size, size_t from)
+  {
+    for (size_t i = from; i + 3 <= size; ++i)
+    {
+      if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1)
+      {
+        return i + 3;
+      }
+    }
+
+    return size;
+  }
+
+  VideoPacketContent classifyVideoPacket(const uint8_t *data, size_t size, bool h265)
+  {
+    // a packet of its own starts with a 3 byte or a 4 byte (00 00 00 01) start code
+    const size_t first = findNalUnit(data, size, 0);
+    bool continuation = first == size || (first != 3 && !(first == 4 && data[0] == 0));
+
+    // the slice header follows the 1 byte (H.264) or 2 byte (H.265) NAL unit header
+    const size_t headerSize = h265 ? 2 : 1;
+    for (size_t nal = first; nal + headerSize < size; nal = findNalUnit(data, size, nal))
+    {
+      const uint32_t type = h265 ? (data[nal] >> 1) & 0x3f : data[nal] & 0x1f;
+      const bool slice = h265 ? type <= 31 : type >= 1 && type <= 5;
+      if (!slice)
+      {
+        continue;
+      }
+
+      // first_mb_in_slice is ue(v), 0 is coded as a single 1 bit; first_slice_segment_in_pic_flag is the first bit
+      if (data[nal + headerSize] & 0x80)
+      {
+        return VIDEO_PACKET_FRAME;
+      }
+      continuation = true;
+    }
+
+    return continuation ? VIDEO_PACKET_CONTINUATION : VIDEO_PACKET_HEADER;
+  }
+
+} // namespace nv